@@ -0,0 +1,264 @@
+#ifndef FIRST_ORDER_LOGIC_FOL_DEMODULATION_HPP
+#define FIRST_ORDER_LOGIC_FOL_DEMODULATION_HPP
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <experimental/optional>
+#include "../first_order_logic.hpp"
+#include "../sentence/term.hpp"
+#include "../sentence/CNF.hpp"
+#include "../sentence/substitution.hpp"
+namespace first_order_logic
+{
+    struct term_bank
+    {
+        typedef std::tuple< term::type, std::string, std::vector< const term::internal * > > key_type;
+        struct key_hash
+        {
+            size_t operator ( )( const key_type & k ) const
+            {
+                size_t ret = std::hash< std::string >( )( std::get< 1 >( k ) ) ^ static_cast< size_t >( std::get< 0 >( k ) );
+                for ( const term::internal * p : std::get< 2 >( k ) )
+                { ret ^= std::hash< const term::internal * >( )( p ) + 0x9e3779b9 + ( ret << 6 ) + ( ret >> 2 ); }
+                return ret;
+            }
+        };
+        std::unordered_map< key_type, term, key_hash > terms;
+        std::unordered_set< const term::internal * > canonical;
+        term operator ( )( const term & t )
+        {
+            if ( canonical.count( t.data.get( ) ) != 0 ) { return t; }
+            std::vector< term > args;
+            std::vector< const term::internal * > key_args;
+            args.reserve( t->arguments.size( ) );
+            key_args.reserve( t->arguments.size( ) );
+            for ( const term & a : t->arguments )
+            {
+                args.push_back( (*this)( a ) );
+                key_args.push_back( args.back( ).data.get( ) );
+            }
+            key_type key( t->term_type, t->name, std::move( key_args ) );
+            auto it = terms.find( key );
+            if ( it != terms.end( ) ) { return it->second; }
+            term ret( t->term_type, t->name, args );
+            canonical.insert( ret.data.get( ) );
+            terms.insert( { std::move( key ), ret } );
+            return ret;
+        }
+    };
+
+    bool KBO_greater( const term & s, const term & t )
+    {
+        std::map< std::string, long > balance;
+        s.variables( common::make_function_output_iterator( [&]( const variable & v ) { ++balance[v.name]; } ) );
+        t.variables( common::make_function_output_iterator( [&]( const variable & v ) { --balance[v.name]; } ) );
+        if ( std::any_of(
+                balance.begin( ),
+                balance.end( ),
+                []( const std::pair< const std::string, long > & p ) { return p.second < 0; } ) )
+        { return false; }
+        size_t ws = s.length( ), wt = t.length( );
+        if ( ws != wt ) { return ws > wt; }
+        if ( s->term_type == term::type::variable || t->term_type == term::type::variable ) { return false; }
+        auto precedence =
+            []( const term & te ) { return std::make_tuple( te->arguments.size( ), te->term_type, te->name ); };
+        if ( precedence( s ) != precedence( t ) ) { return precedence( s ) > precedence( t ); }
+        for ( size_t i = 0; i < s->arguments.size( ); ++i )
+        {
+            if ( s->arguments[i] != t->arguments[i] ) { return KBO_greater( s->arguments[i], t->arguments[i] ); }
+        }
+        return false;
+    }
+
+    struct demodulator
+    {
+        struct rewrite_rule
+        {
+            term lhs, rhs;
+            std::set< literal > source;
+            size_t tag;
+            bool active;
+        };
+        struct checkpoint { size_t rules, deactivated; };
+        term_bank bank;
+        std::vector< rewrite_rule > rules;
+        std::vector< size_t > deactivated;
+        std::map< std::tuple< term::type, std::string, size_t >, std::vector< size_t > > index;
+        std::unordered_map< const term::internal *, std::pair< term, std::vector< size_t > > > normal_forms;
+        static std::tuple< term::type, std::string, size_t > symbol( const term & t )
+        { return std::make_tuple( t->term_type, t->name, t->arguments.size( ) ); }
+        static bool is_equation( const literal & l ) { return l.as.name == "=" && l.as.arguments.size( ) == 2; }
+        std::experimental::optional< std::pair< term, size_t > > rewrite_root( const term & t ) const
+        {
+            auto it = index.find( symbol( t ) );
+            if ( it == index.end( ) ) { return std::experimental::optional< std::pair< term, size_t > >( ); }
+            for ( size_t i : it->second )
+            {
+                if ( ! rules[i].active ) { continue; }
+                auto sub = match( rules[i].lhs, t );
+                if ( sub ) { return std::make_pair( (*sub)( rules[i].rhs ), i ); }
+            }
+            return std::experimental::optional< std::pair< term, size_t > >( );
+        }
+        const std::pair< term, std::vector< size_t > > & normal_form_with_rules( const term & te )
+        {
+            term t = bank( te );
+            auto it = normal_forms.find( t.data.get( ) );
+            if ( it != normal_forms.end( ) ) { return it->second; }
+            std::pair< term, std::vector< size_t > > ret( t, { } );
+            auto use = [&]( const std::vector< size_t > & used )
+            { std::copy( used.begin( ), used.end( ), std::back_inserter( ret.second ) ); };
+            if ( t->term_type == term::type::function )
+            {
+                std::vector< term > args;
+                args.reserve( t->arguments.size( ) );
+                for ( const term & a : t->arguments )
+                {
+                    const auto & nf = normal_form_with_rules( a );
+                    args.push_back( nf.first );
+                    use( nf.second );
+                }
+                ret.first = bank( make_function( t->name, args ) );
+            }
+            auto red = rewrite_root( ret.first );
+            if ( red )
+            {
+                ret.second.push_back( red->second );
+                const auto & nf = normal_form_with_rules( red->first );
+                ret.first = nf.first;
+                use( nf.second );
+            }
+            std::sort( ret.second.begin( ), ret.second.end( ) );
+            ret.second.erase( std::unique( ret.second.begin( ), ret.second.end( ) ), ret.second.end( ) );
+            return normal_forms.insert( { t.data.get( ), std::move( ret ) } ).first->second;
+        }
+        term normal_form( const term & t ) { return normal_form_with_rules( t ).first; }
+        template< typename OUTITER >
+        literal normal_form( const literal & l, OUTITER used )
+        {
+            std::vector< term > args;
+            args.reserve( l.as.arguments.size( ) );
+            for ( const term & t : l.as.arguments )
+            {
+                const auto & nf = normal_form_with_rules( t );
+                args.push_back( nf.first );
+                for ( size_t i : nf.second )
+                {
+                    * used = rules[i].tag;
+                    ++used;
+                }
+            }
+            return literal( make_predicate( l.as.name, args ), l.b );
+        }
+        literal normal_form( const literal & l )
+        { return normal_form( l, common::make_function_output_iterator( []( size_t ) { } ) ); }
+        std::experimental::optional< std::set< literal > > operator ( )( const std::set< literal > & clause )
+        { return (*this)( clause, common::make_function_output_iterator( []( size_t ) { } ) ); }
+        template< typename OUTITER >
+        std::experimental::optional< std::set< literal > > operator ( )( const std::set< literal > & clause, OUTITER used )
+        {
+            std::set< literal > ret;
+            for ( const literal & l : clause )
+            {
+                literal nl = normal_form( l, used );
+                if ( is_equation( nl ) && nl.as.arguments[0].data == nl.as.arguments[1].data )
+                {
+                    if ( nl.b ) { return std::experimental::optional< std::set< literal > >( ); }
+                    continue;
+                }
+                ret.insert( nl );
+            }
+            return ret;
+        }
+        bool add( const std::set< literal > & clause, size_t tag = 0 )
+        {
+            if ( clause.size( ) != 1 || ! clause.begin( )->b || ! is_equation( * clause.begin( ) ) ) { return false; }
+            const term & l = clause.begin( )->as.arguments[0], & r = clause.begin( )->as.arguments[1];
+            rewrite_rule rule;
+            if ( KBO_greater( l, r ) ) { rule = rewrite_rule { bank( l ), bank( r ), clause, tag, true }; }
+            else if ( KBO_greater( r, l ) ) { rule = rewrite_rule { bank( r ), bank( l ), clause, tag, true }; }
+            else { return false; }
+            index[symbol( rule.lhs )].push_back( rules.size( ) );
+            rules.push_back( rule );
+            normal_forms.clear( );
+            return true;
+        }
+        void remove( const std::set< literal > & clause )
+        {
+            for ( size_t i = 0; i < rules.size( ); ++i )
+            {
+                if ( rules[i].active && rules[i].source == clause )
+                {
+                    rules[i].active = false;
+                    deactivated.push_back( i );
+                    normal_forms.clear( );
+                }
+            }
+        }
+        checkpoint get_checkpoint( ) const { return checkpoint { rules.size( ), deactivated.size( ) }; }
+        void rollback( const checkpoint & cp )
+        {
+            while ( deactivated.size( ) > cp.deactivated )
+            {
+                rules[deactivated.back( )].active = true;
+                deactivated.pop_back( );
+            }
+            while ( rules.size( ) > cp.rules )
+            {
+                auto it = index.find( symbol( rules.back( ).lhs ) );
+                it->second.pop_back( );
+                if ( it->second.empty( ) ) { index.erase( it ); }
+                rules.pop_back( );
+            }
+            normal_forms.clear( );
+        }
+        bool reducible( const term & t, const rewrite_rule & rule ) const
+        {
+            if ( symbol( t ) == symbol( rule.lhs ) && match( rule.lhs, t ) ) { return true; }
+            return std::any_of(
+                t->arguments.begin( ),
+                t->arguments.end( ),
+                [&]( const term & te ) { return reducible( te, rule ); } );
+        }
+        bool reducible( const std::set< literal > & clause, const rewrite_rule & rule ) const
+        {
+            return std::any_of(
+                clause.begin( ),
+                clause.end( ),
+                [&]( const literal & l )
+                {
+                    return std::any_of(
+                        l.as.arguments.begin( ),
+                        l.as.arguments.end( ),
+                        [&]( const term & t ) { return reducible( t, rule ); } );
+                } );
+        }
+        static const std::set< literal > & clause_of( const std::set< literal > & c ) { return c; }
+        template< typename T >
+        static const std::set< literal > & clause_of( const std::pair< const std::set< literal >, T > & p )
+        { return p.first; }
+        template< typename CONTAINER, typename OUTITER >
+        OUTITER backward( CONTAINER & clauses, OUTITER result )
+        {
+            assert( ! rules.empty( ) );
+            const rewrite_rule rule = rules.back( );
+            for ( auto it = clauses.begin( ); it != clauses.end( ); )
+            {
+                if ( clause_of( * it ) != rule.source && reducible( clause_of( * it ), rule ) )
+                {
+                    remove( clause_of( * it ) );
+                    * result = * it;
+                    ++result;
+                    it = clauses.erase( it );
+                }
+                else { ++it; }
+            }
+            return result;
+        }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_FOL_DEMODULATION_HPP
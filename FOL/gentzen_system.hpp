@@ -352,6 +352,33 @@ namespace first_order_logic
                                     )( sen ),
                                     b );
                             };
+                    auto try_insert_all =
+                            [&]( bool b )
+                            {
+                                for ( const auto & arg : t.first->arguments )
+                                { try_insert( sequent, boost::get< free_sentence >( arg ), b ); }
+                            };
+                    auto try_branch =
+                            [&]( bool b )
+                            {
+                                assert( branch.empty( ) );
+                                for ( const auto & arg : t.first->arguments )
+                                {
+                                    sequence dt( * this );
+                                    try
+                                    {
+                                        dt.try_insert( dt.sequent, boost::get< free_sentence >( arg ), b );
+                                        branch.push_back(
+                                            std::make_pair
+                                            (
+                                                std::make_pair( dt, proof_tree( ) ),
+                                                std::experimental::optional< validity >( )
+                                            ) );
+                                    }
+                                    catch ( contradiction & con ) { pt.join( con.pt ); }
+                                }
+                                if ( branch.empty( ) ) { throw contradiction { pt }; }
+                            };
                     try
                     {
                         t.first.type_restore_full< void >
@@ -370,100 +397,16 @@ namespace first_order_logic
                                 } ),
                             make_atomic_actor( [&]( const atomic_sentence & as ) { try_insert( expanded, as, t.second ); } ),
                             make_and_actor(
-                                [&]( const free_sentence & l, const free_sentence & r )
+                                [&]( const free_sentence &, const free_sentence & )
                                 {
-                                    if ( t.second )
-                                    {
-                                        try_insert( sequent, l, true );
-                                        try_insert( sequent, r, true );
-                                    }
-                                    else
-                                    {
-                                        assert( branch.empty( ) );
-                                        sequence ldt( * this );
-                                        sequence rdt( * this );
-                                        try
-                                        {
-                                            ldt.try_insert(
-                                                ldt.sequent,
-                                                l,
-                                                false );
-                                            branch.push_back(
-                                                std::make_pair
-                                                (
-                                                    std::make_pair(
-                                                        ldt,
-                                                        proof_tree( )),
-                                                    std::experimental::optional< validity >( )
-                                                ) );
-                                        }
-                                        catch ( contradiction & con ) { pt.join( con.pt ); }
-                                        try
-                                        {
-                                            rdt.try_insert(
-                                                rdt.sequent,
-                                                r,
-                                                false );
-                                            branch.push_back(
-                                                std::make_pair
-                                                (
-                                                    std::make_pair(
-                                                        rdt,
-                                                        proof_tree( ) ),
-                                                    std::experimental::optional< validity >( )
-                                                ) );
-                                        }
-                                        catch ( contradiction & con ) { pt.join( con.pt ); }
-                                        if ( branch.empty( ) ) { throw contradiction { pt }; }
-                                    }
+                                    if ( t.second ) { try_insert_all( true ); }
+                                    else { try_branch( false ); }
                                 } ),
                             make_or_actor(
-                                [&]( const free_sentence & l, const free_sentence & r )
+                                [&]( const free_sentence &, const free_sentence & )
                                 {
-                                    if ( t.second )
-                                    {
-                                        assert( branch.empty( ) );
-                                        sequence ldt( * this );
-                                        sequence rdt( * this );
-                                        try
-                                        {
-                                            ldt.try_insert(
-                                                ldt.sequent,
-                                                l,
-                                                true );
-                                            branch.push_back(
-                                                std::make_pair
-                                                (
-                                                    std::make_pair(
-                                                        ldt,
-                                                        proof_tree( )),
-                                                    std::experimental::optional< validity >( )
-                                                ) );
-                                        }
-                                        catch ( contradiction & con ) { pt.join( con.pt ); }
-                                        try
-                                        {
-                                            rdt.try_insert(
-                                                rdt.sequent,
-                                                r,
-                                                true );
-                                            branch.push_back(
-                                                std::make_pair
-                                                (
-                                                    std::make_pair(
-                                                        rdt,
-                                                        proof_tree( )),
-                                                    std::experimental::optional< validity >( )
-                                                ) );
-                                        }
-                                        catch ( contradiction & con ) { pt.join( con.pt ); }
-                                        if ( branch.empty( ) ) { throw contradiction { pt }; }
-                                    }
-                                    else
-                                    {
-                                        try_insert( sequent, l, false );
-                                        try_insert( sequent, r, false );
-                                    }
+                                    if ( t.second ) { try_branch( true ); }
+                                    else { try_insert_all( false ); }
                                 } ),
                             make_not_actor( [&]( const free_sentence & sen ) { try_insert( sequent, sen, ! t.second ); } )
                         );
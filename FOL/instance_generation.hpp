@@ -0,0 +1,206 @@
+#ifndef FIRST_ORDER_LOGIC_FOL_INSTANCE_GENERATION_HPP
+#define FIRST_ORDER_LOGIC_FOL_INSTANCE_GENERATION_HPP
+#include <map>
+#include <set>
+#include <list>
+#include <string>
+#include <vector>
+#include <limits>
+#include <experimental/optional>
+#include "../sentence/CNF.hpp"
+#include "../sentence/simplify.hpp"
+#include "../sentence/substitution.hpp"
+#include "../sentence/sentence_operations.hpp"
+#include "../satisfiability.hpp"
+#include "../SAT/CDCL.hpp"
+namespace first_order_logic
+{
+    struct instance_generation_engine
+    {
+        CDCL_solver solver;
+        std::map< std::set< literal >, std::vector< size_t > > known;
+        std::vector< std::set< literal > > clauses;
+        std::vector< std::experimental::optional< literal > > selected;
+        bool inconsistent = false;
+        static std::vector< variable > variables( const std::set< literal > & clause )
+        {
+            std::vector< variable > ret;
+            for ( const literal & l : clause )
+            {
+                for ( const term & t : l.as.arguments )
+                {
+                    t.variables(
+                        common::make_function_output_iterator(
+                            [&]( const variable & v )
+                            { if ( std::find( ret.begin( ), ret.end( ), v ) == ret.end( ) ) { ret.push_back( v ); } } ) );
+                }
+            }
+            return ret;
+        }
+        static std::set< literal > apply( const substitution & sub, const std::set< literal > & clause )
+        {
+            std::set< literal > ret;
+            for ( const literal & l : clause ) { ret.insert( sub( l ) ); }
+            return ret;
+        }
+        static term resolve( const substitution & sub, const term & t )
+        {
+            term ret = t;
+            for ( size_t i = 0; i <= sub.data.size( ); ++i )
+            {
+                term next = sub( ret );
+                if ( next == ret ) { break; }
+                ret = next;
+            }
+            return ret;
+        }
+        static std::set< literal > instantiate( const substitution & sub, const std::set< literal > & clause )
+        {
+            std::set< literal > ret;
+            for ( const literal & l : clause )
+            {
+                std::vector< term > args;
+                for ( const term & t : l.as.arguments ) { args.push_back( resolve( sub, t ) ); }
+                ret.insert( literal( make_predicate( l.as.name, args ), l.b ) );
+            }
+            return ret;
+        }
+        static substitution renaming( const std::set< literal > & clause, const std::string & prefix )
+        {
+            substitution ret;
+            std::vector< variable > vars = variables( clause );
+            for ( size_t i = 0; i < vars.size( ); ++i ) { ret.data.insert( { vars[i], make_variable( prefix + std::to_string( i ) ) } ); }
+            return ret;
+        }
+        static literal ground( const literal & l )
+        {
+            substitution sub;
+            for ( const variable & v : variables( { l } ) ) { sub.data.insert( { v, make_constant( "⊥" ) } ); }
+            return sub( l );
+        }
+        static bool variant(
+            const std::vector< literal > & pattern,
+            size_t i,
+            const std::set< literal > & clause,
+            const substitution & sub )
+        {
+            if ( i == pattern.size( ) )
+            {
+                std::set< term > image;
+                for ( const auto & p : sub.data )
+                {
+                    if ( p.second->term_type != term::type::variable || ! image.insert( p.second ).second ) { return false; }
+                }
+                return true;
+            }
+            for ( const literal & l : clause )
+            {
+                if ( l.b != pattern[i].b ||
+                     l.as.name != pattern[i].as.name ||
+                     l.as.arguments.size( ) != pattern[i].as.arguments.size( ) ) { continue; }
+                std::experimental::optional< substitution > ret = sub;
+                for ( size_t j = 0; ret && j < l.as.arguments.size( ); ++j )
+                { ret = match( pattern[i].as.arguments[j], l.as.arguments[j], * ret ); }
+                if ( ret && variant( pattern, i + 1, clause, * ret ) ) { return true; }
+            }
+            return false;
+        }
+        static bool variant( const std::set< literal > & l, const std::set< literal > & r )
+        {
+            return l.size( ) == r.size( ) &&
+                   variant( std::vector< literal >( l.begin( ), l.end( ) ), 0, r, substitution( ) );
+        }
+        bool add_input( const std::set< literal > & clause )
+        {
+            std::set< literal > normal = apply( renaming( clause, "x" ), clause ), abstraction;
+            for ( const literal & l : normal ) { abstraction.insert( ground( l ) ); }
+            std::vector< size_t > & bucket = known[abstraction];
+            for ( size_t i : bucket )
+            {
+                if ( variant( clauses[i], normal ) ) { return false; }
+            }
+            bucket.push_back( clauses.size( ) );
+            if ( ! solver.add_clause( std::list< literal >( abstraction.begin( ), abstraction.end( ) ) ) ) { inconsistent = true; }
+            clauses.push_back( normal );
+            selected.emplace_back( );
+            return true;
+        }
+        bool holds( const literal & l ) const
+        {
+            literal g = ground( l );
+            auto v = solver.encoding.find( g.as );
+            return v && solver.model[* v] == g.b;
+        }
+        void select( )
+        {
+            for ( size_t i = 0; i < clauses.size( ); ++i )
+            {
+                if ( selected[i] && holds( * selected[i] ) ) { continue; }
+                for ( const literal & l : clauses[i] )
+                {
+                    if ( holds( l ) )
+                    {
+                        selected[i] = l;
+                        break;
+                    }
+                }
+            }
+        }
+        std::experimental::optional< satisfiability > saturate(
+            size_t max_round = std::numeric_limits< size_t >::max( ) )
+        {
+            while ( true )
+            {
+                if ( inconsistent || solver.solve( ) == satisfiability::unsatisfiable ) { return satisfiability::unsatisfiable; }
+                if ( max_round-- == 0 ) { return std::experimental::optional< satisfiability >( ); }
+                select( );
+                std::map< std::pair< std::string, bool >, std::vector< size_t > > index;
+                for ( size_t i = 0; i < clauses.size( ); ++i )
+                { index[{ selected[i]->as.name, selected[i]->b }].push_back( i ); }
+                std::vector< std::set< literal > > instances;
+                for ( size_t i = 0; i < clauses.size( ); ++i )
+                {
+                    const literal & l = * selected[i];
+                    if ( ! l.b ) { continue; }
+                    auto it = index.find( { l.as.name, false } );
+                    if ( it == index.end( ) ) { continue; }
+                    for ( size_t j : it->second )
+                    {
+                        substitution apart = renaming( clauses[j], "y" );
+                        auto un = unify( l.as, apart( * selected[j] ).as );
+                        if ( ! un ) { continue; }
+                        instances.push_back( instantiate( * un, clauses[i] ) );
+                        instances.push_back( instantiate( * un, apply( apart, clauses[j] ) ) );
+                    }
+                }
+                bool added = false;
+                for ( const auto & c : instances ) { added = add_input( c ) || added; }
+                if ( ! added ) { return satisfiability::satisfiable; }
+            }
+        }
+    };
+
+    std::experimental::optional< satisfiability > instance_generation(
+        const free_propositional_sentence & sen,
+        size_t max_round = std::numeric_limits< size_t >::max( ) )
+    {
+        instance_generation_engine engine;
+        for ( const auto & clause : collect_set_set_literal( [&]( auto out ) { simplified_CNF( sen, out ); } ) )
+        { engine.add_input( clause ); }
+        return engine.saturate( max_round );
+    }
+
+    validity instance_generation(
+        const free_sentence & sen,
+        const free_sentence & goal,
+        size_t max_round = std::numeric_limits< size_t >::max( ) )
+    {
+        auto ret =
+            instance_generation(
+                drop_universal( skolemization_remove_existential( move_quantifier_out( rectify(
+                    make_and( sen, restore_quantifier_universal( make_not( goal ) ) ) ) ) ) ),
+                max_round );
+        return ret && * ret == satisfiability::unsatisfiable ? validity::valid : validity::invalid;
+    }
+}
+#endif //FIRST_ORDER_LOGIC_FOL_INSTANCE_GENERATION_HPP
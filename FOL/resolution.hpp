@@ -6,71 +6,195 @@
 #include "sentence/sentence_operations.hpp"
 #include "../cpp_common/iterator.hpp"
 #include "sentence/CNF.hpp"
+#include "sentence/simplify.hpp"
 #include "satisfiability.hpp"
+#include "demodulation.hpp"
+#include "resolution_proof.hpp"
+#include <limits>
 namespace first_order_logic
 {
-    satisfiability resolution( const free_propositional_sentence & sen )
+    struct resolution_engine
     {
-        auto CNF = set_set_literal( sen );
-        std::set< std::set< literal > > to_be_added;
-        bool have_new_inference = true;
-        while ( have_new_inference )
+        struct checkpoint
+        {
+            size_t records, trail, processed;
+            demodulator::checkpoint dem;
+        };
+        resolution_proof proof;
+        std::map< std::set< literal >, size_t > CNF;
+        demodulator dem;
+        std::vector< std::pair< bool, size_t > > trail;
+        size_t processed = 0;
+        std::vector< checkpoint > checkpoints;
+        void insert( const std::set< literal > & clause, size_t id )
+        {
+            CNF.insert( { clause, id } );
+            trail.push_back( { true, id } );
+        }
+        bool add_clause( size_t id )
+        {
+            bool ret = false;
+            std::vector< size_t > pending( 1, id );
+            while ( ! pending.empty( ) && ! proof.empty_clause )
+            {
+                size_t i = pending.back( );
+                pending.pop_back( );
+                std::vector< size_t > used;
+                auto cl = dem( proof[i].clause, std::back_inserter( used ) );
+                if ( ! cl || CNF.count( * cl ) != 0 ) { continue; }
+                if ( * cl != proof[i].clause )
+                {
+                    used.insert( used.begin( ), i );
+                    i = proof.add( * cl, inference_rule::demodulation, used );
+                }
+                ret = true;
+                insert( * cl, i );
+                if ( dem.add( * cl, i ) )
+                {
+                    dem.backward(
+                        CNF,
+                        common::make_function_output_iterator(
+                            [&]( const std::pair< const std::set< literal >, size_t > & p )
+                            {
+                                trail.push_back( { false, p.second } );
+                                pending.push_back( p.second );
+                            } ) );
+                }
+            }
+            return ret;
+        }
+        bool add_input( const std::set< literal > & clause )
+        { return add_clause( proof.add( clause, inference_rule::input ) ); }
+        std::experimental::optional< satisfiability > saturate(
+            size_t max_round = std::numeric_limits< size_t >::max( ) )
         {
-            have_new_inference = false;
-            for ( const auto & l : CNF )
+            if ( proof.empty_clause ) { return satisfiability::unsatisfiable; }
+            std::map< std::set< literal >, std::tuple< size_t, size_t, substitution > > to_be_added;
+            bool have_new_inference = true;
+            while ( have_new_inference )
             {
-                for ( const auto & r : CNF )
+                if ( max_round-- == 0 ) { return std::experimental::optional< satisfiability >( ); }
+                have_new_inference = false;
+                for ( const auto & lp : CNF )
                 {
-                    if ( l != r )
+                    const std::set< literal > & l = lp.first;
+                    for ( const auto & rp : CNF )
                     {
-                        for ( const literal & ll : l )
+                        const std::set< literal > & r = rp.first;
+                        if ( l != r && std::max( lp.second, rp.second ) >= processed )
                         {
-                            for ( const literal & rr : r )
+                            for ( const literal & ll : l )
                             {
-                                if ( ll.b != rr.b )
+                                for ( const literal & rr : r )
                                 {
-                                    auto un = unify( ll.as, rr.as );
-                                    if ( un )
+                                    if ( ll.b != rr.b )
                                     {
-                                        std::set< literal > cl;
-                                        for ( const literal & ins : l )
+                                        auto un = unify( ll.as, rr.as );
+                                        if ( un )
                                         {
-                                            if ( (*un)( ins ) != (*un)( ll ) )
-                                            { cl.insert( (*un)( ins ) ); }
+                                            std::set< literal > cl;
+                                            for ( const literal & ins : l )
+                                            {
+                                                if ( (*un)( ins ) != (*un)( ll ) )
+                                                { cl.insert( (*un)( ins ) ); }
+                                            }
+                                            for ( const literal & ins : r )
+                                            {
+                                                if ( (*un)( ins ) != (*un)( rr ) )
+                                                { cl.insert( (*un)( ins ) ); }
+                                            }
+                                            if ( cl.empty( ) )
+                                            {
+                                                proof.add( cl, inference_rule::resolution, { lp.second, rp.second }, * un );
+                                                return satisfiability::unsatisfiable;
+                                            }
+                                            to_be_added.insert( { cl, std::make_tuple( lp.second, rp.second, * un ) } );
                                         }
-                                        for ( const literal & ins : r )
-                                        {
-                                            if ( (*un)( ins ) != (*un)( rr ) )
-                                            { cl.insert( (*un)( ins ) ); }
-                                        }
-                                        if ( cl.empty( ) ) { return satisfiability::unsatisfiable; }
-                                        to_be_added.insert( cl );
                                     }
                                 }
                             }
                         }
                     }
                 }
-            }
-            for ( const auto & clause : to_be_added )
-            {
-                if ( CNF.count( clause ) == 0 )
+                processed = proof.size( );
+                for ( const auto & p : to_be_added )
                 {
-                    CNF.insert( clause );
-                    have_new_inference = true;
+                    if ( CNF.count( p.first ) == 0 )
+                    {
+                        size_t id =
+                            proof.add(
+                                p.first,
+                                inference_rule::resolution,
+                                { std::get< 0 >( p.second ), std::get< 1 >( p.second ) },
+                                std::get< 2 >( p.second ) );
+                        have_new_inference = add_clause( id ) || have_new_inference;
+                    }
                 }
+                if ( proof.empty_clause ) { return satisfiability::unsatisfiable; }
+                to_be_added.clear( );
+                std::vector< size_t > live;
+                live.reserve( CNF.size( ) );
+                for ( const auto & p : CNF ) { live.push_back( p.second ); }
+                proof.discard_non_ancestors(
+                    live.begin( ),
+                    live.end( ),
+                    checkpoints.empty( ) ? 0 : checkpoints.back( ).records );
             }
-            to_be_added.clear( );
+            return satisfiability::satisfiable;
         }
-        return satisfiability::satisfiable;
+        void push( )
+        { checkpoints.push_back( checkpoint { proof.size( ), trail.size( ), processed, dem.get_checkpoint( ) } ); }
+        void pop( )
+        {
+            assert( ! checkpoints.empty( ) );
+            checkpoint cp = checkpoints.back( );
+            checkpoints.pop_back( );
+            while ( trail.size( ) > cp.trail )
+            {
+                if ( ! trail.back( ).first && trail.back( ).second < cp.records )
+                { CNF.insert( { proof[trail.back( ).second].clause, trail.back( ).second } ); }
+                trail.pop_back( );
+            }
+            for ( auto it = CNF.begin( ); it != CNF.end( ); )
+            {
+                if ( it->second >= cp.records ) { it = CNF.erase( it ); }
+                else { ++it; }
+            }
+            proof.truncate( cp.records );
+            processed = cp.processed;
+            dem.rollback( cp.dem );
+        }
+    };
+
+    satisfiability resolution( const free_propositional_sentence & sen, resolution_proof & proof )
+    {
+        resolution_engine engine;
+        for ( const auto & clause : collect_set_set_literal( [&]( auto out ) { simplified_CNF( sen, out ); } ) )
+        { engine.add_input( clause ); }
+        satisfiability ret = engine.saturate( ).value( );
+        proof = std::move( engine.proof );
+        return ret;
     }
 
-    validity resolution( const free_sentence & sen, const free_sentence & goal )
+    satisfiability resolution( const free_propositional_sentence & sen )
+    {
+        resolution_proof proof;
+        return resolution( sen, proof );
+    }
+
+    validity resolution( const free_sentence & sen, const free_sentence & goal, resolution_proof & proof )
     {
         return is_satisfiable( resolution( drop_universal( skolemization_remove_existential( move_quantifier_out( rectify(
                     make_and(
                         sen,
-                        restore_quantifier_universal( make_not( goal ) ) ) ) ) ) ) ) ) ? validity::invalid : validity::valid;
+                        restore_quantifier_universal( make_not( goal ) ) ) ) ) ) ), proof ) ).value( ) ?
+                validity::invalid : validity::valid;
+    }
+
+    validity resolution( const free_sentence & sen, const free_sentence & goal )
+    {
+        resolution_proof proof;
+        return resolution( sen, goal, proof );
     }
 }
 #endif //FIRST_ORDER_LOGIC_FOL_RESOLUTION_HPP
@@ -0,0 +1,128 @@
+#ifndef FIRST_ORDER_LOGIC_FOL_RESOLUTION_PROOF_HPP
+#define FIRST_ORDER_LOGIC_FOL_RESOLUTION_PROOF_HPP
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <experimental/optional>
+#include "../sentence/CNF.hpp"
+#include "../sentence/substitution.hpp"
+namespace first_order_logic
+{
+    enum class inference_rule { input, resolution, demodulation, discarded };
+    std::string to_string( inference_rule r )
+    {
+        return
+            r == inference_rule::input ? "input" :
+            r == inference_rule::resolution ? "resolution" :
+            r == inference_rule::demodulation ? "demodulation" : "discarded";
+    }
+    template< typename OS >
+    OS & operator << ( OS & os, inference_rule r ) { return os << to_string( r ); }
+    struct resolution_proof
+    {
+        struct clause_record
+        {
+            std::set< literal > clause;
+            inference_rule rule;
+            std::vector< size_t > parents;
+            substitution unifier;
+        };
+        std::vector< clause_record > records;
+        std::experimental::optional< size_t > empty_clause;
+        const clause_record & operator [ ]( size_t id ) const { return records[id]; }
+        size_t size( ) const { return records.size( ); }
+        size_t add(
+            const std::set< literal > & clause,
+            inference_rule rule,
+            const std::vector< size_t > & parents = { },
+            const substitution & unifier = substitution( ) )
+        {
+            records.push_back( clause_record { clause, rule, parents, unifier } );
+            if ( clause.empty( ) && ! empty_clause ) { empty_clause = records.size( ) - 1; }
+            return records.size( ) - 1;
+        }
+        template< typename INITER >
+        std::vector< bool > ancestors( INITER begin, INITER end ) const
+        {
+            std::vector< bool > ret( records.size( ), false );
+            std::vector< size_t > stack( begin, end );
+            while ( ! stack.empty( ) )
+            {
+                size_t id = stack.back( );
+                stack.pop_back( );
+                if ( ret[id] ) { continue; }
+                ret[id] = true;
+                std::copy( records[id].parents.begin( ), records[id].parents.end( ), std::back_inserter( stack ) );
+            }
+            return ret;
+        }
+        template< typename INITER >
+        void discard_non_ancestors( INITER begin, INITER end, size_t keep_prefix = 0 )
+        {
+            std::vector< bool > keep = ancestors( begin, end );
+            for ( size_t i = keep_prefix; i < records.size( ); ++i )
+            {
+                if ( ! keep[i] && records[i].rule != inference_rule::discarded )
+                { records[i] = clause_record { { }, inference_rule::discarded, { }, substitution( ) }; }
+            }
+        }
+        void truncate( size_t size )
+        {
+            records.resize( size, clause_record { { }, inference_rule::discarded, { }, substitution( ) } );
+            if ( empty_clause && * empty_clause >= size ) { empty_clause = std::experimental::optional< size_t >( ); }
+        }
+        resolution_proof extract_refutation( ) const
+        {
+            resolution_proof ret;
+            std::map< size_t, size_t > renumber;
+            for ( size_t id : refutation( ) )
+            {
+                std::vector< size_t > parents;
+                for ( size_t p : records[id].parents ) { parents.push_back( renumber[p] ); }
+                renumber[id] = ret.add( records[id].clause, records[id].rule, parents, records[id].unifier );
+            }
+            return ret;
+        }
+        std::vector< size_t > refutation( ) const
+        {
+            std::vector< size_t > ret;
+            if ( ! empty_clause ) { return ret; }
+            std::vector< bool > used = ancestors( & * empty_clause, & * empty_clause + 1 );
+            for ( size_t i = 0; i < used.size( ); ++i ) { if ( used[i] ) { ret.push_back( i ); } }
+            return ret;
+        }
+        std::string to_string( size_t id ) const
+        {
+            const clause_record & r = records[id];
+            std::string ret = std::to_string( id ) + ": {";
+            for ( auto it = r.clause.begin( ); it != r.clause.end( ); ++it )
+            {
+                if ( it != r.clause.begin( ) ) { ret += ", "; }
+                ret += ( it->b ? "" : "!" ) + static_cast< const std::string & >( it->as );
+            }
+            ret += "} " + first_order_logic::to_string( r.rule );
+            for ( size_t p : r.parents ) { ret += " " + std::to_string( p ); }
+            if ( ! r.unifier.data.empty( ) )
+            {
+                ret += " [";
+                for ( auto it = r.unifier.data.begin( ); it != r.unifier.data.end( ); ++it )
+                {
+                    if ( it != r.unifier.data.begin( ) ) { ret += ", "; }
+                    ret += it->first.name + "/" + static_cast< std::string >( it->second );
+                }
+                ret += "]";
+            }
+            return ret;
+        }
+    };
+
+    template< typename OS >
+    OS & operator << ( OS & os, const resolution_proof & proof )
+    {
+        for ( size_t id : proof.refutation( ) ) { os << proof.to_string( id ) << "\n"; }
+        return os;
+    }
+}
+#endif //FIRST_ORDER_LOGIC_FOL_RESOLUTION_PROOF_HPP
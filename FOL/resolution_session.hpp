@@ -0,0 +1,118 @@
+#ifndef FIRST_ORDER_LOGIC_FOL_RESOLUTION_SESSION_HPP
+#define FIRST_ORDER_LOGIC_FOL_RESOLUTION_SESSION_HPP
+#include <map>
+#include <set>
+#include <string>
+#include <limits>
+#include <experimental/optional>
+#include "resolution.hpp"
+#include "resolution_proof.hpp"
+#include "../sentence/sentence_operations.hpp"
+#include "../sentence/simplify.hpp"
+namespace first_order_logic
+{
+    struct resolution_session
+    {
+        resolution_engine engine;
+        std::set< std::string > used_symbols;
+        std::experimental::optional< satisfiability > axiom_status;
+        static std::set< std::set< literal > > clausify( const free_sentence & sen )
+        {
+            free_propositional_sentence matrix =
+                drop_universal( skolemization_remove_existential( move_quantifier_out( rectify( sen ) ) ) );
+            return collect_set_set_literal( [&]( auto out ) { simplified_CNF( matrix, out ); } );
+        }
+        static term rename_symbols( const term & t, const std::map< std::string, std::string > & rename )
+        {
+            if ( t->term_type == term::type::variable ) { return t; }
+            auto it = rename.find( t->name );
+            std::vector< term > args;
+            args.reserve( t->arguments.size( ) );
+            for ( const term & a : t->arguments ) { args.push_back( rename_symbols( a, rename ) ); }
+            return term( t->term_type, it == rename.end( ) ? t->name : it->second, args );
+        }
+        resolution_session( ) { }
+        explicit resolution_session( const free_sentence & axioms ) { add_axiom( axioms ); }
+        void add_axiom( const free_sentence & axiom )
+        {
+            assert( engine.checkpoints.empty( ) );
+            for ( const auto & clause : clausify( axiom ) )
+            {
+                for ( const literal & l : clause )
+                { used_name( l.as, std::inserter( used_symbols, used_symbols.begin( ) ) ); }
+                engine.add_input( clause );
+            }
+            if ( engine.proof.empty_clause ) { axiom_status = satisfiability::unsatisfiable; }
+        }
+        std::experimental::optional< satisfiability > saturate(
+            size_t max_round = std::numeric_limits< size_t >::max( ) )
+        {
+            if ( ! axiom_status ) { axiom_status = engine.saturate( max_round ); }
+            return axiom_status;
+        }
+        std::set< std::set< literal > > negated_goal( const free_sentence & goal ) const
+        {
+            free_sentence negated = restore_quantifier_universal( make_not( goal ) );
+            std::set< std::string > goal_names;
+            used_name( negated, std::inserter( goal_names, goal_names.begin( ) ) );
+            std::map< std::string, std::string > rename;
+            auto avoid_clash =
+                [&]( const std::string & name )
+                {
+                    if ( goal_names.count( name ) != 0 || used_symbols.count( name ) == 0 || rename.count( name ) != 0 )
+                    { return; }
+                    std::string fresh = name;
+                    while ( used_symbols.count( fresh ) != 0 || goal_names.count( fresh ) != 0 ) { fresh += "_"; }
+                    goal_names.insert( fresh );
+                    rename.insert( { name, fresh } );
+                };
+            std::set< std::set< literal > > ret;
+            for ( const auto & clause : clausify( negated ) )
+            {
+                std::set< literal > renamed;
+                for ( const literal & l : clause )
+                {
+                    std::vector< term > args;
+                    for ( const term & t : l.as.arguments )
+                    {
+                        t.functions(
+                            common::make_function_output_iterator(
+                                [&]( const function & f ) { avoid_clash( f.name ); } ) );
+                        t.constants(
+                            common::make_function_output_iterator(
+                                [&]( const constant & c ) { avoid_clash( c.name ); } ) );
+                        args.push_back( rename_symbols( t, rename ) );
+                    }
+                    renamed.insert( literal( make_predicate( l.as.name, args ), l.b ) );
+                }
+                ret.insert( renamed );
+            }
+            return ret;
+        }
+        validity prove(
+            const free_sentence & goal,
+            resolution_proof & refutation,
+            size_t max_round = std::numeric_limits< size_t >::max( ) )
+        {
+            if ( axiom_status && * axiom_status == satisfiability::unsatisfiable )
+            {
+                refutation = engine.proof.extract_refutation( );
+                return validity::valid;
+            }
+            engine.push( );
+            for ( const auto & clause : negated_goal( goal ) ) { engine.add_input( clause ); }
+            auto res = engine.saturate( max_round );
+            validity ret =
+                res && * res == satisfiability::unsatisfiable ? validity::valid : validity::invalid;
+            if ( ret == validity::valid ) { refutation = engine.proof.extract_refutation( ); }
+            engine.pop( );
+            return ret;
+        }
+        validity prove( const free_sentence & goal, size_t max_round = std::numeric_limits< size_t >::max( ) )
+        {
+            resolution_proof refutation;
+            return prove( goal, refutation, max_round );
+        }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_FOL_RESOLUTION_SESSION_HPP
@@ -0,0 +1,709 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_CDCL_HPP
+#define FIRST_ORDER_LOGIC_SAT_CDCL_HPP
+#include <map>
+#include <list>
+#include <deque>
+#include <atomic>
+#include <random>
+#include <functional>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
+#include "../satisfiability.hpp"
+#include "../sentence/CNF.hpp"
+#include "../cpp_common/iterator.hpp"
+#include "encoding.hpp"
+#include "clause_arena.hpp"
+#include "activity_heap.hpp"
+#include "preprocessor.hpp"
+#include "DRAT.hpp"
+namespace first_order_logic
+{
+    struct CDCL_config
+    {
+        enum class restart_policy { none, luby, glucose };
+        restart_policy restart = restart_policy::glucose;
+        double variable_decay = 0.95;
+        bool phase_saving = true;
+        bool initial_phase = false;
+        size_t luby_unit = 100;
+        size_t glucose_window = 50;
+        double glucose_margin = 0.8;
+        size_t reduce_interval = 2000;
+        size_t reduce_increment = 300;
+        uint32_t core_LBD = 2;
+        uint32_t tier2_LBD = 6;
+        double clause_decay = 0.999;
+        double garbage_fraction = 0.2;
+        bool preprocess = false;
+        uint32_t seed = 0;
+        preprocess_config preprocessing;
+    };
+    inline size_t luby( size_t i )
+    {
+        size_t size = 1, power = 1;
+        while ( size < i + 1 )
+        {
+            size = size * 2 + 1;
+            power *= 2;
+        }
+        while ( size - 1 != i )
+        {
+            size = ( size - 1 ) / 2;
+            power /= 2;
+            i %= size;
+        }
+        return power;
+    }
+    struct CDCL_solver
+    {
+        typedef literal_code lit;
+        enum : clause_ref { no_reason = clause_arena::no_clause };
+        static lit make_lit( uint32_t var, bool b ) { return encode_literal( var, b ); }
+        static uint32_t var( lit l ) { return literal_variable( l ); }
+        static bool sign( lit l ) { return literal_sign( l ); }
+        static lit negate( lit l ) { return negate_literal( l ); }
+        struct watcher
+        {
+            clause_ref clause;
+            lit blocker;
+        };
+        CDCL_config config;
+        variable_encoding encoding;
+        clause_arena arena;
+        std::vector< clause_ref > clauses, learnts_core, learnts_tier2, learnts_local;
+        std::vector< std::vector< watcher > > watches;
+        std::vector< signed char > assigns;
+        std::vector< size_t > level;
+        std::vector< clause_ref > reason;
+        std::vector< char > seen;
+        std::vector< lit > trail;
+        std::vector< size_t > trail_lim;
+        std::vector< bool > model;
+        std::vector< lit > model_decisions;
+        std::vector< lit > assumptions, failed;
+        activity_heap order;
+        double variable_increment = 1;
+        float clause_increment = 1;
+        size_t reductions = 0, next_reduction = 0;
+        std::vector< char > polarity;
+        std::vector< size_t > level_stamp;
+        size_t stamp = 0;
+        size_t conflicts = 0, restarts = 0, conflicts_since_restart = 0;
+        std::deque< uint32_t > recent_LBD;
+        double recent_LBD_sum = 0, LBD_sum = 0;
+        size_t qhead = 0;
+        bool inconsistent = false;
+        std::mt19937 random;
+        const std::atomic< bool > * interrupt = nullptr;
+        DRAT_writer * proof = nullptr;
+        std::function< void( const std::vector< lit > & ) > export_clause;
+        std::function< void( std::vector< std::vector< lit > > & ) > import_clauses;
+        CDCL_solver( ) { }
+        explicit CDCL_solver( const CDCL_config & config ) : config( config ), random( config.seed ) { }
+        uint32_t new_variable( )
+        {
+            uint32_t ret = static_cast< uint32_t >( assigns.size( ) );
+            assigns.push_back( 0 );
+            level.push_back( 0 );
+            reason.push_back( no_reason );
+            seen.push_back( 0 );
+            polarity.push_back( config.seed == 0 ? config.initial_phase : random( ) % 2 == 0 );
+            if ( config.seed != 0 ) { order.bump( ret, std::uniform_real_distribution<>( 0, 1e-5 )( random ) ); }
+            order.insert( ret );
+            watches.emplace_back( );
+            watches.emplace_back( );
+            return ret;
+        }
+        uint32_t variable( const atomic_sentence & as )
+        {
+            uint32_t ret = encoding( as );
+            while ( num_variables( ) <= ret ) { new_variable( ); }
+            return ret;
+        }
+        size_t num_variables( ) const { return assigns.size( ); }
+        size_t decision_level( ) const { return trail_lim.size( ); }
+        signed char value( lit l ) const { return sign( l ) ? assigns[var( l )] : -assigns[var( l )]; }
+        void enqueue( lit l, clause_ref from )
+        {
+            assert( value( l ) == 0 );
+            assigns[var( l )] = sign( l ) ? 1 : -1;
+            level[var( l )] = decision_level( );
+            reason[var( l )] = from;
+            trail.push_back( l );
+        }
+        void attach( clause_ref id )
+        {
+            const_clause_view c = arena[id];
+            assert( c.size( ) >= 2 );
+            watches[c[0]].push_back( watcher { id, c[1] } );
+            watches[c[1]].push_back( watcher { id, c[0] } );
+        }
+        bool add_clause( std::vector< lit > c )
+        {
+            assert( decision_level( ) == 0 );
+            if ( inconsistent ) { return false; }
+            for ( lit l : c ) { while ( num_variables( ) <= var( l ) ) { new_variable( ); } }
+            std::sort( c.begin( ), c.end( ) );
+            c.erase( std::unique( c.begin( ), c.end( ) ), c.end( ) );
+            for ( size_t i = 1; i < c.size( ); ++i ) { if ( c[i] == negate( c[i - 1] ) ) { return true; } }
+            if ( std::any_of( c.begin( ), c.end( ), [&]( lit l ) { return value( l ) > 0; } ) ) { return true; }
+            size_t size = c.size( );
+            c.erase( std::remove_if( c.begin( ), c.end( ), [&]( lit l ) { return value( l ) < 0; } ), c.end( ) );
+            if ( proof != nullptr && c.size( ) != size ) { proof->add( c ); }
+            if ( c.empty( ) ) { return ! ( inconsistent = true ); }
+            if ( c.size( ) == 1 )
+            {
+                enqueue( c[0], no_reason );
+                if ( propagate( ) != no_reason )
+                {
+                    inconsistent = true;
+                    if ( proof != nullptr ) { proof->add( std::vector< lit >( ) ); }
+                }
+                return ! inconsistent;
+            }
+            clauses.push_back( arena.alloc( c.begin( ), c.end( ) ) );
+            attach( clauses.back( ) );
+            return true;
+        }
+        lit encode( const literal & l ) { return make_lit( variable( l.as ), l.b ); }
+        bool add_clause( const std::list< literal > & cl )
+        {
+            std::vector< lit > c;
+            for ( const literal & l : cl ) { c.push_back( encode( l ) ); }
+            return add_clause( std::move( c ) );
+        }
+        bool add_clause( const std::vector< literal > & cl ) { return add_clause( std::list< literal >( cl.begin( ), cl.end( ) ) ); }
+        clause_ref propagate( )
+        {
+            while ( qhead < trail.size( ) )
+            {
+                lit false_lit = negate( trail[qhead++] );
+                std::vector< watcher > & ws = watches[false_lit];
+                size_t i = 0, j = 0;
+                while ( i < ws.size( ) )
+                {
+                    watcher w = ws[i++];
+                    if ( value( w.blocker ) > 0 )
+                    {
+                        ws[j++] = w;
+                        continue;
+                    }
+                    clause_view c = arena[w.clause];
+                    if ( c[0] == false_lit ) { std::swap( c[0], c[1] ); }
+                    assert( c[1] == false_lit );
+                    if ( c[0] != w.blocker && value( c[0] ) > 0 )
+                    {
+                        ws[j++] = watcher { w.clause, c[0] };
+                        continue;
+                    }
+                    bool moved = false;
+                    for ( size_t k = 2; k < c.size( ); ++k )
+                    {
+                        if ( value( c[k] ) >= 0 )
+                        {
+                            std::swap( c[1], c[k] );
+                            watches[c[1]].push_back( watcher { w.clause, c[0] } );
+                            moved = true;
+                            break;
+                        }
+                    }
+                    if ( moved ) { continue; }
+                    ws[j++] = watcher { w.clause, c[0] };
+                    if ( value( c[0] ) < 0 )
+                    {
+                        while ( i < ws.size( ) ) { ws[j++] = ws[i++]; }
+                        ws.resize( j );
+                        qhead = trail.size( );
+                        return w.clause;
+                    }
+                    enqueue( c[0], w.clause );
+                }
+                ws.resize( j );
+            }
+            return no_reason;
+        }
+        uint32_t abstract_level( uint32_t v ) const { return 1u << ( level[v] & 31 ); }
+        bool redundant( lit p, uint32_t levels, std::vector< lit > & to_clear )
+        {
+            std::vector< lit > stack { p };
+            size_t top = to_clear.size( );
+            while ( ! stack.empty( ) )
+            {
+                const_clause_view c = arena[reason[var( stack.back( ) )]];
+                stack.pop_back( );
+                for ( size_t i = 1; i < c.size( ); ++i )
+                {
+                    uint32_t v = var( c[i] );
+                    if ( seen[v] || level[v] == 0 ) { continue; }
+                    if ( reason[v] != no_reason && ( abstract_level( v ) & levels ) != 0 )
+                    {
+                        seen[v] = 1;
+                        stack.push_back( c[i] );
+                        to_clear.push_back( c[i] );
+                    }
+                    else
+                    {
+                        for ( size_t k = top; k < to_clear.size( ); ++k ) { seen[var( to_clear[k] )] = 0; }
+                        to_clear.resize( top );
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        std::vector< lit > analyze( clause_ref conflict, size_t & backjump )
+        {
+            std::vector< lit > learnt( 1 );
+            size_t path = 0, index = trail.size( );
+            lit p = 0;
+            bool first = true;
+            do
+            {
+                assert( conflict != no_reason );
+                const_clause_view c = arena[conflict];
+                if ( c.learnt( ) ) { touch_clause( conflict ); }
+                for ( size_t i = first ? 0 : 1; i < c.size( ); ++i )
+                {
+                    uint32_t v = var( c[i] );
+                    if ( seen[v] || level[v] == 0 ) { continue; }
+                    seen[v] = 1;
+                    bump_variable( v );
+                    if ( level[v] >= decision_level( ) ) { ++path; }
+                    else { learnt.push_back( c[i] ); }
+                }
+                while ( ! seen[var( trail[--index] )] ) { }
+                p = trail[index];
+                conflict = reason[var( p )];
+                seen[var( p )] = 0;
+                first = false;
+            }
+            while ( --path > 0 );
+            learnt[0] = negate( p );
+            std::vector< lit > to_clear( learnt.begin( ) + 1, learnt.end( ) );
+            uint32_t levels = 0;
+            for ( size_t i = 1; i < learnt.size( ); ++i ) { levels |= abstract_level( var( learnt[i] ) ); }
+            size_t j = 1;
+            for ( size_t i = 1; i < learnt.size( ); ++i )
+            {
+                if ( reason[var( learnt[i] )] == no_reason || ! redundant( learnt[i], levels, to_clear ) )
+                { learnt[j++] = learnt[i]; }
+            }
+            learnt.resize( j );
+            for ( lit l : to_clear ) { seen[var( l )] = 0; }
+            backjump = 0;
+            if ( learnt.size( ) > 1 )
+            {
+                size_t max = 1;
+                for ( size_t i = 2; i < learnt.size( ); ++i )
+                { if ( level[var( learnt[i] )] > level[var( learnt[max] )] ) { max = i; } }
+                std::swap( learnt[1], learnt[max] );
+                backjump = level[var( learnt[1] )];
+            }
+            return learnt;
+        }
+        void bump_variable( uint32_t v )
+        {
+            if ( order.bump( v, variable_increment ) )
+            {
+                order.rescale( 1e-100 );
+                variable_increment *= 1e-100;
+            }
+        }
+        template< typename RANGE >
+        uint32_t LBD( const RANGE & c )
+        {
+            level_stamp.resize( decision_level( ) + 1, 0 );
+            ++stamp;
+            uint32_t ret = 0;
+            for ( lit l : c )
+            {
+                size_t & s = level_stamp[level[var( l )]];
+                if ( s != stamp )
+                {
+                    s = stamp;
+                    ++ret;
+                }
+            }
+            return ret;
+        }
+        void touch_clause( clause_ref c )
+        {
+            clause_view v = arena[c];
+            v.set_used( true );
+            if ( v.LBD( ) > config.core_LBD )
+            {
+                uint32_t lbd = LBD( v );
+                if ( lbd < v.LBD( ) ) { v.set_LBD( lbd ); }
+            }
+            v.set_activity( v.activity( ) + clause_increment );
+            if ( v.activity( ) > 1e20f )
+            {
+                for ( auto * tier : { & learnts_core, & learnts_tier2, & learnts_local } )
+                {
+                    for ( clause_ref r : * tier ) { arena[r].set_activity( arena[r].activity( ) * 1e-20f ); }
+                }
+                clause_increment *= 1e-20f;
+            }
+        }
+        std::vector< clause_ref > & tier( uint32_t lbd )
+        { return lbd <= config.core_LBD ? learnts_core : lbd <= config.tier2_LBD ? learnts_tier2 : learnts_local; }
+        bool locked( clause_ref c ) const
+        {
+            const_clause_view v = arena[c];
+            return value( v[0] ) > 0 && reason[var( v[0] )] == c;
+        }
+        void reduce( )
+        {
+            std::vector< clause_ref > tier2, demoted, candidates;
+            for ( clause_ref c : learnts_tier2 )
+            {
+                clause_view v = arena[c];
+                if ( v.LBD( ) <= config.core_LBD ) { learnts_core.push_back( c ); }
+                else if ( v.used( ) )
+                {
+                    v.set_used( false );
+                    tier2.push_back( c );
+                }
+                else { demoted.push_back( c ); }
+            }
+            learnts_tier2.swap( tier2 );
+            for ( clause_ref c : learnts_local )
+            {
+                clause_view v = arena[c];
+                if ( v.used( ) && v.LBD( ) <= config.tier2_LBD )
+                {
+                    v.set_used( false );
+                    tier( v.LBD( ) ).push_back( c );
+                }
+                else { candidates.push_back( c ); }
+            }
+            learnts_local.clear( );
+            std::sort(
+                candidates.begin( ),
+                candidates.end( ),
+                [&]( clause_ref l, clause_ref r ) { return arena[l].activity( ) < arena[r].activity( ); } );
+            for ( size_t i = 0; i < candidates.size( ); ++i )
+            {
+                clause_view v = arena[candidates[i]];
+                if ( i < candidates.size( ) / 2 && ! v.used( ) && ! locked( candidates[i] ) )
+                {
+                    if ( proof != nullptr ) { proof->remove( v ); }
+                    arena.free( candidates[i] );
+                }
+                else
+                {
+                    v.set_used( false );
+                    learnts_local.push_back( candidates[i] );
+                }
+            }
+            learnts_local.insert( learnts_local.end( ), demoted.begin( ), demoted.end( ) );
+            for ( std::vector< watcher > & ws : watches )
+            {
+                ws.erase(
+                    std::remove_if( ws.begin( ), ws.end( ), [&]( const watcher & w ) { return arena[w.clause].deleted( ); } ),
+                    ws.end( ) );
+            }
+            if ( arena.wasted > arena.size( ) * config.garbage_fraction ) { collect_garbage( ); }
+            ++reductions;
+        }
+        void collect_garbage( )
+        {
+            clause_arena to;
+            to.data.reserve( arena.size( ) - arena.wasted );
+            for ( auto * list : { & clauses, & learnts_core, & learnts_tier2, & learnts_local } )
+            { for ( clause_ref & c : * list ) { c = arena.relocate( c, to ); } }
+            for ( std::vector< watcher > & ws : watches )
+            { for ( watcher & w : ws ) { w.clause = arena.relocate( w.clause, to ); } }
+            for ( lit l : trail )
+            { if ( reason[var( l )] != no_reason ) { reason[var( l )] = arena.relocate( reason[var( l )], to ); } }
+            arena = std::move( to );
+        }
+        bool restart_due( ) const
+        {
+            switch ( config.restart )
+            {
+            case CDCL_config::restart_policy::luby:
+                return conflicts_since_restart >= luby( restarts ) * config.luby_unit;
+            case CDCL_config::restart_policy::glucose:
+                return
+                    recent_LBD.size( ) >= config.glucose_window &&
+                    recent_LBD_sum / recent_LBD.size( ) * config.glucose_margin > LBD_sum / conflicts;
+            default:
+                return false;
+            }
+        }
+        void restart( )
+        {
+            backtrack( 0 );
+            if ( import_clauses )
+            {
+                std::vector< std::vector< lit > > shared;
+                import_clauses( shared );
+                for ( auto & c : shared ) { if ( ! add_clause( std::move( c ) ) ) { break; } }
+            }
+            ++restarts;
+            conflicts_since_restart = 0;
+            recent_LBD.clear( );
+            recent_LBD_sum = 0;
+        }
+        void record_conflict( uint32_t lbd )
+        {
+            ++conflicts;
+            ++conflicts_since_restart;
+            LBD_sum += lbd;
+            recent_LBD.push_back( lbd );
+            recent_LBD_sum += lbd;
+            if ( recent_LBD.size( ) > config.glucose_window )
+            {
+                recent_LBD_sum -= recent_LBD.front( );
+                recent_LBD.pop_front( );
+            }
+            variable_increment /= config.variable_decay;
+            clause_increment /= config.clause_decay;
+        }
+        void backtrack( size_t to )
+        {
+            if ( decision_level( ) <= to ) { return; }
+            for ( size_t i = trail.size( ); i > trail_lim[to]; --i )
+            {
+                uint32_t v = var( trail[i - 1] );
+                if ( config.phase_saving ) { polarity[v] = assigns[v] > 0; }
+                assigns[v] = 0;
+                reason[v] = no_reason;
+                order.insert( v );
+            }
+            trail.resize( trail_lim[to] );
+            trail_lim.resize( to );
+            qhead = trail.size( );
+        }
+        std::experimental::optional< lit > pick_branch( )
+        {
+            while ( ! order.empty( ) )
+            {
+                uint32_t v = order.pop( );
+                if ( assigns[v] == 0 ) { return make_lit( v, polarity[v] != 0 ); }
+            }
+            return std::experimental::optional< lit >( );
+        }
+        void analyze_final( lit p )
+        {
+            failed.assign( 1, negate( p ) );
+            if ( decision_level( ) == 0 ) { return; }
+            seen[var( p )] = 1;
+            for ( size_t i = trail.size( ); i > trail_lim[0]; --i )
+            {
+                uint32_t v = var( trail[i - 1] );
+                if ( ! seen[v] ) { continue; }
+                if ( reason[v] == no_reason ) { failed.push_back( trail[i - 1] ); }
+                else
+                {
+                    const_clause_view c = arena[reason[v]];
+                    for ( size_t k = 1; k < c.size( ); ++k ) { if ( level[var( c[k] )] > 0 ) { seen[var( c[k] )] = 1; } }
+                }
+                seen[v] = 0;
+            }
+            seen[var( p )] = 0;
+        }
+        std::vector< literal > failed_assumptions( ) const
+        {
+            std::vector< literal > ret;
+            for ( lit l : failed ) { ret.push_back( encoding.decode( l ) ); }
+            return ret;
+        }
+        satisfiability solve( const std::vector< literal > & assumption )
+        {
+            std::vector< lit > codes;
+            for ( const literal & l : assumption ) { codes.push_back( encode( l ) ); }
+            return solve( codes );
+        }
+        satisfiability solve( ) { return solve( std::vector< lit >( ) ); }
+        satisfiability solve( const std::vector< lit > & assumption )
+        {
+            assumptions = assumption;
+            failed.clear( );
+            satisfiability ret = search( );
+            backtrack( 0 );
+            return ret;
+        }
+        bool assume( lit l )
+        {
+            assert( value( l ) == 0 );
+            trail_lim.push_back( trail.size( ) );
+            enqueue( l, no_reason );
+            return propagate( ) == no_reason;
+        }
+        std::map< atomic_sentence, bool > model_map( ) const { return encoding.decode( model ); }
+        template< typename OUTITER >
+        size_t enumerate(
+            OUTITER out,
+            size_t limit = std::numeric_limits< size_t >::max( ),
+            const std::vector< uint32_t > & projection = { } )
+        {
+            size_t ret = 0;
+            while ( ret < limit && solve( ) == satisfiability::satisfiable )
+            {
+                if ( projection.empty( ) ) { * out = model_map( ); }
+                else
+                {
+                    std::map< atomic_sentence, bool > projected;
+                    for ( uint32_t v : projection ) { projected.insert( { encoding.atom( v ), model[v] } ); }
+                    * out = projected;
+                }
+                ++out;
+                ++ret;
+                std::vector< lit > blocking;
+                if ( projection.empty( ) ) { for ( lit l : model_decisions ) { blocking.push_back( negate( l ) ); } }
+                else { for ( uint32_t v : projection ) { blocking.push_back( make_lit( v, ! model[v] ) ); } }
+                if ( ! add_clause( std::move( blocking ) ) ) { break; }
+            }
+            return ret;
+        }
+        satisfiability search( )
+        {
+            if ( inconsistent ) { return satisfiability::unsatisfiable; }
+            while ( true )
+            {
+                clause_ref conflict = propagate( );
+                if ( conflict != no_reason )
+                {
+                    if ( decision_level( ) == 0 )
+                    {
+                        inconsistent = true;
+                        if ( proof != nullptr ) { proof->add( std::vector< lit >( ) ); }
+                        return satisfiability::unsatisfiable;
+                    }
+                    size_t backjump;
+                    std::vector< lit > learnt = analyze( conflict, backjump );
+                    uint32_t lbd = LBD( learnt );
+                    record_conflict( lbd );
+                    if ( proof != nullptr ) { proof->add( learnt ); }
+                    if ( export_clause ) { export_clause( learnt ); }
+                    backtrack( backjump );
+                    if ( learnt.size( ) == 1 ) { enqueue( learnt[0], no_reason ); }
+                    else
+                    {
+                        clause_ref c = arena.alloc( learnt.begin( ), learnt.end( ), true, lbd );
+                        tier( lbd ).push_back( c );
+                        attach( c );
+                        touch_clause( c );
+                        enqueue( learnt[0], c );
+                    }
+                    if ( conflicts >= next_reduction )
+                    {
+                        if ( next_reduction != 0 ) { reduce( ); }
+                        next_reduction = conflicts + config.reduce_interval + reductions * config.reduce_increment;
+                    }
+                    if ( restart_due( ) ) { restart( ); }
+                    if ( inconsistent ) { return satisfiability::unsatisfiable; }
+                    if ( interrupt != nullptr && interrupt->load( std::memory_order_relaxed ) ) { return satisfiability::unknown; }
+                }
+                else
+                {
+                    std::experimental::optional< lit > next;
+                    while ( decision_level( ) < assumptions.size( ) )
+                    {
+                        lit a = assumptions[decision_level( )];
+                        if ( value( a ) > 0 ) { trail_lim.push_back( trail.size( ) ); }
+                        else if ( value( a ) < 0 )
+                        {
+                            analyze_final( negate( a ) );
+                            return satisfiability::unsatisfiable;
+                        }
+                        else
+                        {
+                            next = a;
+                            break;
+                        }
+                    }
+                    if ( ! next ) { next = pick_branch( ); }
+                    if ( ! next )
+                    {
+                        model.assign( assigns.size( ), false );
+                        for ( uint32_t v = 0; v < assigns.size( ); ++v ) { model[v] = assigns[v] > 0; }
+                        model_decisions.clear( );
+                        for ( size_t start : trail_lim )
+                        {
+                            if ( start < trail.size( ) && reason[var( trail[start] )] == no_reason )
+                            { model_decisions.push_back( trail[start] ); }
+                        }
+                        return satisfiability::satisfiable;
+                    }
+                    trail_lim.push_back( trail.size( ) );
+                    enqueue( * next, no_reason );
+                }
+            }
+        }
+    };
+
+    satisfiability CDCL(
+        const std::list< std::list< literal > > & cnf,
+        std::map< atomic_sentence, bool > & model,
+        const CDCL_config & config = CDCL_config( ) )
+    {
+        CDCL_solver solver( config );
+        satisfiability ret;
+        if ( config.preprocess )
+        {
+            preprocessor pre( config.preprocessing );
+            for ( const auto & cl : cnf )
+            {
+                std::vector< literal_code > c;
+                for ( const literal & l : cl ) { c.push_back( solver.encode( l ) ); }
+                pre.add_clause( std::move( c ) );
+            }
+            if ( ! pre.run( ) ) { return satisfiability::unsatisfiable; }
+            pre.simplified(
+                common::make_function_output_iterator(
+                    [&]( const std::vector< literal_code > & c ) { solver.add_clause( c ); } ) );
+            ret = solver.solve( );
+            pre.extend( solver.model );
+        }
+        else
+        {
+            for ( const auto & cl : cnf ) { if ( ! solver.add_clause( cl ) ) { return satisfiability::unsatisfiable; } }
+            ret = solver.solve( );
+        }
+        if ( ret == satisfiability::satisfiable ) { model = solver.encoding.decode( solver.model ); }
+        return ret;
+    }
+    satisfiability CDCL(
+        const std::list< std::list< literal > > & cnf,
+        std::map< atomic_sentence, bool > & model,
+        DRAT_writer & proof,
+        const CDCL_config & config = CDCL_config( ) )
+    {
+        if ( config.preprocess ) { throw std::invalid_argument( "CDCL: preprocessing does not log DRAT steps" ); }
+        CDCL_solver solver( config );
+        solver.proof = & proof;
+        satisfiability ret = satisfiability::unsatisfiable;
+        if ( std::all_of( cnf.begin( ), cnf.end( ), [&]( const std::list< literal > & cl ) { return solver.add_clause( cl ); } ) )
+        { ret = solver.solve( ); }
+        if ( ret == satisfiability::satisfiable ) { model = solver.encoding.decode( solver.model ); }
+        proof.flush( );
+        return ret;
+    }
+    satisfiability CDCL( const std::list< std::list< literal > > & cnf, const CDCL_config & config = CDCL_config( ) )
+    {
+        std::map< atomic_sentence, bool > model;
+        return CDCL( cnf, model, config );
+    }
+    template< typename OUTITER >
+    size_t enumerate_models(
+        const std::list< std::list< literal > > & cnf,
+        OUTITER out,
+        size_t limit = std::numeric_limits< size_t >::max( ),
+        const std::vector< atomic_sentence > & projection = { },
+        const CDCL_config & config = CDCL_config( ) )
+    {
+        CDCL_solver solver( config );
+        for ( const auto & cl : cnf ) { solver.add_clause( cl ); }
+        std::vector< uint32_t > vars;
+        for ( const atomic_sentence & as : projection ) { vars.push_back( solver.variable( as ) ); }
+        return solver.enumerate( out, limit, vars );
+    }
+}
+#endif //FIRST_ORDER_LOGIC_SAT_CDCL_HPP
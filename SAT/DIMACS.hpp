@@ -0,0 +1,258 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_DIMACS_HPP
+#define FIRST_ORDER_LOGIC_SAT_DIMACS_HPP
+#include <list>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "encoding.hpp"
+#include "clause_arena.hpp"
+#include "../cpp_common/iterator.hpp"
+namespace first_order_logic
+{
+    struct DIMACS_header
+    {
+        size_t variables = 0;
+        size_t clauses = 0;
+    };
+    template< typename HANDLER >
+    struct DIMACS_parser
+    {
+        enum class state { line_start, comment, header, body, end };
+        HANDLER handler;
+        state st = state::line_start;
+        std::string header_line;
+        std::vector< int64_t > clause;
+        int64_t number = 0;
+        bool in_number = false, negative = false;
+        explicit DIMACS_parser( HANDLER handler ) : handler( handler ) { }
+        void end_number( )
+        {
+            if ( ! in_number )
+            {
+                if ( negative ) { throw std::invalid_argument( "DIMACS: dangling '-'" ); }
+                return;
+            }
+            if ( number == 0 )
+            {
+                handler.clause( static_cast< const std::vector< int64_t > & >( clause ) );
+                clause.clear( );
+            }
+            else { clause.push_back( negative ? -number : number ); }
+            number = 0;
+            in_number = negative = false;
+        }
+        void end_header( )
+        {
+            std::istringstream is( header_line );
+            std::string p, format;
+            DIMACS_header ret;
+            if ( ! ( is >> p >> format >> ret.variables >> ret.clauses ) || format != "cnf" )
+            { throw std::invalid_argument( "DIMACS: malformed header '" + header_line + "'" ); }
+            header_line.clear( );
+            handler.header( ret );
+        }
+        void body( char c )
+        {
+            if ( c >= '0' && c <= '9' )
+            {
+                if ( number > ( std::numeric_limits< int64_t >::max( ) - ( c - '0' ) ) / 10 )
+                { throw std::invalid_argument( "DIMACS: number out of range" ); }
+                number = number * 10 + ( c - '0' );
+                in_number = true;
+            }
+            else if ( c == '-' && ! in_number && ! negative ) { negative = true; }
+            else if ( c == ' ' || c == '\t' || c == '\r' || c == '\n' )
+            {
+                end_number( );
+                if ( c == '\n' ) { st = state::line_start; }
+            }
+            else { throw std::invalid_argument( std::string( "DIMACS: unexpected character '" ) + c + "'" ); }
+        }
+        void feed( const char * begin, const char * end )
+        {
+            for ( const char * it = begin; it != end; ++it )
+            {
+                char c = * it;
+                switch ( st )
+                {
+                case state::end:
+                    return;
+                case state::comment:
+                    if ( c == '\n' ) { st = state::line_start; }
+                    break;
+                case state::header:
+                    if ( c == '\n' )
+                    {
+                        end_header( );
+                        st = state::line_start;
+                    }
+                    else { header_line += c; }
+                    break;
+                case state::line_start:
+                    if ( c == 'c' )
+                    {
+                        st = state::comment;
+                        break;
+                    }
+                    if ( c == 'p' )
+                    {
+                        header_line = c;
+                        st = state::header;
+                        break;
+                    }
+                    if ( c == '%' )
+                    {
+                        st = state::end;
+                        return;
+                    }
+                    st = state::body;
+                    body( c );
+                    break;
+                case state::body:
+                    body( c );
+                    break;
+                }
+            }
+        }
+        void finish( )
+        {
+            if ( st == state::header ) { end_header( ); }
+            if ( st == state::body ) { end_number( ); }
+            if ( ! clause.empty( ) )
+            {
+                handler.clause( static_cast< const std::vector< int64_t > & >( clause ) );
+                clause.clear( );
+            }
+        }
+    };
+    struct DIMACS_variables
+    {
+        variable_encoding & encoding;
+        std::vector< uint32_t > dense;
+        explicit DIMACS_variables( variable_encoding & encoding ) : encoding( encoding ), dense( 1 ) { }
+        uint32_t operator ( )( size_t n )
+        {
+            while ( dense.size( ) <= n )
+            { dense.push_back( encoding( make_propositional_letter( std::to_string( dense.size( ) ) ) ) ); }
+            return dense[n];
+        }
+    };
+    template< typename OUTITER >
+    struct DIMACS_reader
+    {
+        DIMACS_variables variables;
+        DIMACS_header read_header;
+        std::vector< literal_code > codes;
+        OUTITER out;
+        DIMACS_reader( variable_encoding & encoding, OUTITER out ) : variables( encoding ), out( out ) { }
+        void header( const DIMACS_header & h )
+        {
+            read_header = h;
+            if ( h.variables > 0 ) { variables( h.variables ); }
+        }
+        void clause( const std::vector< int64_t > & clause )
+        {
+            codes.clear( );
+            for ( int64_t l : clause )
+            {
+                size_t v = static_cast< size_t >( l < 0 ? -l : l );
+                if ( v > read_header.variables )
+                { throw std::invalid_argument( "DIMACS: literal " + std::to_string( l ) + " exceeds declared variable count" ); }
+                codes.push_back( encode_literal( variables( v ), l > 0 ) );
+            }
+            * out = static_cast< const std::vector< literal_code > & >( codes );
+            ++out;
+        }
+    };
+    template< typename OUTITER >
+    DIMACS_header read_DIMACS( std::istream & in, variable_encoding & encoding, OUTITER out )
+    {
+        DIMACS_reader< OUTITER > reader( encoding, out );
+        DIMACS_parser< DIMACS_reader< OUTITER > & > parser( reader );
+        std::vector< char > buffer( 1 << 16 );
+        while ( in.read( buffer.data( ), buffer.size( ) ) || in.gcount( ) > 0 )
+        { parser.feed( buffer.data( ), buffer.data( ) + in.gcount( ) ); }
+        parser.finish( );
+        return reader.read_header;
+    }
+    template< typename OUTITER >
+    DIMACS_header read_DIMACS_file( const std::string & path, variable_encoding & encoding, OUTITER out )
+    {
+#if defined( __unix__ ) || defined( __APPLE__ )
+        int fd = ::open( path.c_str( ), O_RDONLY );
+        if ( fd < 0 ) { throw std::invalid_argument( "DIMACS: cannot open " + path ); }
+        struct stat st;
+        void * map = ::fstat( fd, & st ) == 0 && st.st_size > 0 ?
+            ::mmap( nullptr, static_cast< size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 ) : MAP_FAILED;
+        ::close( fd );
+        if ( map != MAP_FAILED )
+        {
+            struct unmap
+            {
+                void * map;
+                size_t size;
+                ~unmap( ) { ::munmap( map, size ); }
+            } guard { map, static_cast< size_t >( st.st_size ) };
+            ::madvise( map, guard.size, MADV_SEQUENTIAL );
+            DIMACS_reader< OUTITER > reader( encoding, out );
+            DIMACS_parser< DIMACS_reader< OUTITER > & > parser( reader );
+            const char * begin = static_cast< const char * >( map );
+            parser.feed( begin, begin + guard.size );
+            parser.finish( );
+            return reader.read_header;
+        }
+#endif
+        std::ifstream in( path, std::ios::binary );
+        if ( ! in ) { throw std::invalid_argument( "DIMACS: cannot open " + path ); }
+        return read_DIMACS( in, encoding, out );
+    }
+    DIMACS_header read_DIMACS(
+        std::istream & in, variable_encoding & encoding, clause_arena & arena, std::vector< clause_ref > & clauses )
+    {
+        return read_DIMACS(
+            in,
+            encoding,
+            common::make_function_output_iterator(
+                [&]( const std::vector< literal_code > & c ) { clauses.push_back( arena.alloc( c.begin( ), c.end( ) ) ); } ) );
+    }
+
+    template< typename OS, typename INITER >
+    OS & write_DIMACS( OS & os, size_t variables, const clause_arena & arena, INITER begin, INITER end )
+    {
+        os << "p cnf " << variables << " " << std::distance( begin, end ) << "\n";
+        for ( ; begin != end; ++begin )
+        {
+            for ( literal_code l : arena[* begin] ) { os << ( literal_sign( l ) ? "" : "-" ) << literal_variable( l ) + 1 << " "; }
+            os << "0\n";
+        }
+        return os;
+    }
+    template< typename OS >
+    OS & write_DIMACS( OS & os, const std::list< std::list< literal > > & cnf )
+    {
+        variable_encoding encoding;
+        clause_arena arena;
+        std::vector< clause_ref > clauses;
+        for ( const auto & cl : cnf )
+        {
+            std::vector< literal_code > c;
+            for ( const literal & l : cl ) { c.push_back( encoding( l ) ); }
+            clauses.push_back( arena.alloc( c.begin( ), c.end( ) ) );
+        }
+        for ( uint32_t v = 0; v < encoding.size( ); ++v ) { os << "c " << v + 1 << " " << encoding.atom( v ) << "\n"; }
+        return write_DIMACS( os, encoding.size( ), arena, clauses.begin( ), clauses.end( ) );
+    }
+}
+#endif //FIRST_ORDER_LOGIC_SAT_DIMACS_HPP
@@ -62,13 +62,17 @@ namespace first_order_logic
         }
         return cnf;
     }
-    satisfiability DPLL( const std::list< std::list< literal > > & cnf, std::vector< literal > optimize )
+    satisfiability DPLL(
+        const std::list< std::list< literal > > & cnf,
+        std::vector< literal > optimize,
+        std::map< atomic_sentence, bool > & model )
     {
         if ( ! optimize.empty( ) )
         {
             auto ret = optimize.back( );
             optimize.pop_back( );
-            return DPLL( substitute( cnf, ret.as, ret.b ), std::move( optimize ) );
+            model[ret.as] = ret.b;
+            return DPLL( substitute( cnf, ret.as, ret.b ), std::move( optimize ), model );
         }
         else
         {
@@ -76,14 +80,26 @@ namespace first_order_logic
             if ( std::any_of( cnf.begin( ), cnf.end( ), []( const auto & p ){ return p.empty( ); } ) ) { return satisfiability::unsatisfiable; }
             find_pure_symbol( cnf, std::back_inserter( optimize ) );
             find_unit_clause( cnf, std::back_inserter( optimize ) );
-            if ( ! optimize.empty( ) ) { return DPLL( cnf, std::move( optimize ) ); }
+            if ( ! optimize.empty( ) ) { return DPLL( cnf, std::move( optimize ), model ); }
             assert( cnf.begin( )->begin( ) != cnf.begin( )->end( ) );
-            return
-                (is_satisfiable( DPLL( substitute( cnf, cnf.begin( )->begin( )->as, true ), optimize ) ).value( ) ||
-                is_satisfiable( DPLL( substitute( cnf, cnf.begin( )->begin( )->as, false ), optimize ) ).value( ) ) ?
-                        satisfiability::satisfiable : satisfiability::unsatisfiable;
+            const atomic_sentence & as = cnf.begin( )->begin( )->as;
+            model[as] = true;
+            if ( is_satisfiable( DPLL( substitute( cnf, as, true ), optimize, model ) ).value( ) ) { return satisfiability::satisfiable; }
+            model[as] = false;
+            return DPLL( substitute( cnf, as, false ), optimize, model );
         }
     }
+    satisfiability DPLL( const std::list< std::list< literal > > & cnf, std::vector< literal > optimize )
+    {
+        std::map< atomic_sentence, bool > model;
+        return DPLL( cnf, std::move( optimize ), model );
+    }
+    satisfiability DPLL( const std::list< std::list< literal > > & cnf, std::map< atomic_sentence, bool > & model )
+    {
+        model.clear( );
+        for ( const auto & cl : cnf ) { for ( const literal & l : cl ) { model.insert( { l.as, false } ); } }
+        return DPLL( cnf, { }, model );
+    }
     satisfiability DPLL( const std::list< std::list< literal > > & cnf ) { return DPLL( cnf, { } ); }
 }
 #endif //FIRST_ORDER_LOGIC_SAT_DPLL_HPP
@@ -0,0 +1,35 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_DRAT_HPP
+#define FIRST_ORDER_LOGIC_SAT_DRAT_HPP
+#include <vector>
+#include <ostream>
+#include "encoding.hpp"
+#include "buffered_writer.hpp"
+namespace first_order_logic
+{
+    struct DRAT_writer : buffered_writer
+    {
+        explicit DRAT_writer( std::ostream & os, size_t buffer_size = 1 << 20 ) : buffered_writer( os, buffer_size ) { }
+        template< typename RANGE >
+        void step( char kind, const RANGE & c )
+        {
+            buffer.push_back( kind );
+            for ( literal_code l : c )
+            {
+                uint64_t u = static_cast< uint64_t >( l ) + 2;
+                while ( u > 127 )
+                {
+                    buffer.push_back( static_cast< char >( ( u & 127 ) | 128 ) );
+                    u >>= 7;
+                }
+                buffer.push_back( static_cast< char >( u ) );
+            }
+            buffer.push_back( 0 );
+            if ( buffer.size( ) >= buffer_size ) { hand_off( ); }
+        }
+        template< typename RANGE >
+        void add( const RANGE & c ) { step( 'a', c ); }
+        template< typename RANGE >
+        void remove( const RANGE & c ) { step( 'd', c ); }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_DRAT_HPP
@@ -0,0 +1,346 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_DRAT_CHECKER_HPP
+#define FIRST_ORDER_LOGIC_SAT_DRAT_CHECKER_HPP
+#include <map>
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include "encoding.hpp"
+#include "clause_arena.hpp"
+#include "DIMACS.hpp"
+#include "../cpp_common/iterator.hpp"
+namespace first_order_logic
+{
+    struct DRAT_step
+    {
+        bool deletion;
+        std::vector< literal_code > clause;
+    };
+    template< typename ITER, typename OUTITER >
+    OUTITER parse_binary_DRAT( ITER begin, ITER end, OUTITER out )
+    {
+        while ( begin != end )
+        {
+            unsigned char kind = static_cast< unsigned char >( * begin++ );
+            if ( kind != 'a' && kind != 'd' ) { throw std::invalid_argument( "DRAT: unexpected step marker" ); }
+            DRAT_step step { kind == 'd', { } };
+            while ( true )
+            {
+                uint64_t u = 0;
+                size_t shift = 0;
+                while ( true )
+                {
+                    if ( begin == end ) { throw std::invalid_argument( "DRAT: truncated step" ); }
+                    unsigned char byte = static_cast< unsigned char >( * begin++ );
+                    u |= static_cast< uint64_t >( byte & 127 ) << shift;
+                    if ( ( byte & 128 ) == 0 ) { break; }
+                    shift += 7;
+                    if ( shift > 35 ) { throw std::invalid_argument( "DRAT: literal out of range" ); }
+                }
+                if ( u == 0 ) { break; }
+                if ( u < 2 ) { throw std::invalid_argument( "DRAT: literal out of range" ); }
+                step.clause.push_back( static_cast< literal_code >( u - 2 ) );
+            }
+            * out = std::move( step );
+            ++out;
+        }
+        return out;
+    }
+    struct DRAT_checker
+    {
+        enum : size_t { no_reason = std::numeric_limits< size_t >::max( ) };
+        struct record
+        {
+            size_t id;
+            bool deletion;
+            literal_code pivot;
+        };
+        clause_arena arena;
+        std::vector< clause_ref > clauses;
+        std::vector< bool > active, core;
+        std::vector< size_t > units;
+        std::vector< std::vector< size_t > > watches;
+        std::vector< signed char > assigns;
+        std::vector< size_t > reason;
+        std::vector< bool > seen;
+        std::vector< literal_code > trail;
+        std::map< std::vector< literal_code >, std::vector< size_t > > lookup;
+        std::vector< record > steps;
+        size_t core_head = 0, all_head = 0;
+        bool empty_input = false, refuted = false, indexed = false;
+        signed char value( literal_code l ) const
+        { return literal_sign( l ) ? assigns[literal_variable( l )] : -assigns[literal_variable( l )]; }
+        void grow( literal_code l )
+        {
+            while ( assigns.size( ) <= literal_variable( l ) )
+            {
+                assigns.push_back( 0 );
+                reason.push_back( no_reason );
+                seen.push_back( false );
+                watches.emplace_back( );
+                watches.emplace_back( );
+            }
+        }
+        size_t insert( const std::vector< literal_code > & c )
+        {
+            std::vector< literal_code > lits;
+            for ( literal_code l : c )
+            {
+                grow( l );
+                if ( std::find( lits.begin( ), lits.end( ), l ) == lits.end( ) ) { lits.push_back( l ); }
+            }
+            size_t ret = clauses.size( );
+            clauses.push_back( arena.alloc( lits.begin( ), lits.end( ) ) );
+            active.push_back( true );
+            core.push_back( false );
+            if ( lits.size( ) == 1 ) { units.push_back( ret ); }
+            else if ( lits.size( ) >= 2 )
+            {
+                watches[lits[0]].push_back( ret );
+                watches[lits[1]].push_back( ret );
+            }
+            return ret;
+        }
+        void enqueue( literal_code l, size_t from )
+        {
+            assigns[literal_variable( l )] = literal_sign( l ) ? 1 : -1;
+            reason[literal_variable( l )] = from;
+            trail.push_back( l );
+        }
+        void undo( )
+        {
+            for ( literal_code l : trail ) { assigns[literal_variable( l )] = 0; }
+            trail.clear( );
+            core_head = all_head = 0;
+        }
+        size_t visit( literal_code false_lit, bool core_mode )
+        {
+            std::vector< size_t > & ws = watches[false_lit];
+            size_t i = 0, j = 0, ret = no_reason;
+            while ( i < ws.size( ) )
+            {
+                size_t id = ws[i++];
+                if ( ! active[id] || core[id] != core_mode )
+                {
+                    ws[j++] = id;
+                    continue;
+                }
+                clause_view c = arena[clauses[id]];
+                if ( c[0] == false_lit ) { std::swap( c[0], c[1] ); }
+                if ( value( c[0] ) > 0 )
+                {
+                    ws[j++] = id;
+                    continue;
+                }
+                bool moved = false;
+                for ( size_t k = 2; k < c.size( ); ++k )
+                {
+                    if ( value( c[k] ) >= 0 )
+                    {
+                        std::swap( c[1], c[k] );
+                        watches[c[1]].push_back( id );
+                        moved = true;
+                        break;
+                    }
+                }
+                if ( moved ) { continue; }
+                ws[j++] = id;
+                if ( value( c[0] ) < 0 )
+                {
+                    ret = id;
+                    break;
+                }
+                enqueue( c[0], id );
+                if ( ! core_mode ) { break; }
+            }
+            while ( i < ws.size( ) ) { ws[j++] = ws[i++]; }
+            ws.resize( j );
+            return ret;
+        }
+        size_t propagate( )
+        {
+            while ( true )
+            {
+                while ( core_head < trail.size( ) )
+                {
+                    size_t conflict = visit( negate_literal( trail[core_head++] ), true );
+                    if ( conflict != no_reason ) { return conflict; }
+                }
+                size_t size = trail.size( );
+                while ( all_head < trail.size( ) && trail.size( ) == size )
+                {
+                    size_t conflict = visit( negate_literal( trail[all_head] ), false );
+                    if ( conflict != no_reason ) { return conflict; }
+                    if ( trail.size( ) == size ) { ++all_head; }
+                }
+                if ( trail.size( ) == size ) { return no_reason; }
+            }
+        }
+        void mark( size_t conflict )
+        {
+            core[conflict] = true;
+            for ( literal_code l : arena[clauses[conflict]] ) { seen[literal_variable( l )] = true; }
+            for ( size_t i = trail.size( ); i > 0; --i )
+            {
+                uint32_t v = literal_variable( trail[i - 1] );
+                if ( ! seen[v] ) { continue; }
+                seen[v] = false;
+                if ( reason[v] == no_reason ) { continue; }
+                core[reason[v]] = true;
+                for ( literal_code l : arena[clauses[reason[v]]] ) { seen[literal_variable( l )] = true; }
+            }
+            for ( literal_code l : arena[clauses[conflict]] ) { seen[literal_variable( l )] = false; }
+        }
+        bool RUP( const std::vector< literal_code > & c )
+        {
+            for ( literal_code l : c ) { grow( l ); }
+            size_t conflict = no_reason;
+            for ( literal_code l : c )
+            {
+                if ( value( l ) < 0 ) { continue; }
+                if ( value( l ) > 0 )
+                {
+                    undo( );
+                    return true;
+                }
+                enqueue( negate_literal( l ), no_reason );
+            }
+            for ( size_t u : units )
+            {
+                if ( ! active[u] ) { continue; }
+                literal_code l = arena[clauses[u]][0];
+                if ( value( l ) > 0 ) { continue; }
+                if ( value( l ) < 0 )
+                {
+                    conflict = u;
+                    break;
+                }
+                enqueue( l, u );
+            }
+            if ( conflict == no_reason ) { conflict = propagate( ); }
+            if ( conflict != no_reason ) { mark( conflict ); }
+            undo( );
+            return conflict != no_reason;
+        }
+        bool RAT( const std::vector< literal_code > & c )
+        {
+            if ( c.empty( ) ) { return false; }
+            literal_code pivot = negate_literal( c[0] );
+            for ( size_t id = 0; id < clauses.size( ); ++id )
+            {
+                const_clause_view d = arena[clauses[id]];
+                if ( ! active[id] || std::find( d.begin( ), d.end( ), pivot ) == d.end( ) ) { continue; }
+                std::vector< literal_code > resolvent( c );
+                std::copy_if( d.begin( ), d.end( ), std::back_inserter( resolvent ), [&]( literal_code l ) { return l != pivot; } );
+                if ( ! RUP( resolvent ) ) { return false; }
+                core[id] = true;
+            }
+            return true;
+        }
+        void add_formula( const std::vector< std::vector< literal_code > > & formula )
+        {
+            for ( const auto & c : formula )
+            {
+                if ( c.empty( ) ) { empty_input = true; }
+                insert( c );
+            }
+        }
+        static std::vector< literal_code > key( std::vector< literal_code > c )
+        {
+            std::sort( c.begin( ), c.end( ) );
+            c.erase( std::unique( c.begin( ), c.end( ) ), c.end( ) );
+            return c;
+        }
+        void step( const DRAT_step & s )
+        {
+            if ( empty_input || refuted ) { return; }
+            if ( ! indexed )
+            {
+                for ( size_t id = 0; id < clauses.size( ); ++id )
+                {
+                    const_clause_view c = arena[clauses[id]];
+                    lookup[key( std::vector< literal_code >( c.begin( ), c.end( ) ) )].push_back( id );
+                }
+                indexed = true;
+            }
+            if ( ! s.deletion )
+            {
+                if ( s.clause.empty( ) )
+                {
+                    refuted = true;
+                    return;
+                }
+                size_t id = insert( s.clause );
+                lookup[key( s.clause )].push_back( id );
+                steps.push_back( record { id, false, s.clause[0] } );
+                return;
+            }
+            auto it = lookup.find( key( s.clause ) );
+            if ( it == lookup.end( ) || it->second.empty( ) ) { return; }
+            steps.push_back( record { it->second.back( ), true, 0 } );
+            active[it->second.back( )] = false;
+            it->second.pop_back( );
+        }
+        bool verify( )
+        {
+            if ( empty_input ) { return true; }
+            if ( ! RUP( { } ) ) { return false; }
+            for ( size_t i = steps.size( ); i > 0; --i )
+            {
+                const record & r = steps[i - 1];
+                active[r.id] = r.deletion;
+                if ( r.deletion || ! core[r.id] ) { continue; }
+                const_clause_view c = arena[clauses[r.id]];
+                std::vector< literal_code > lemma( c.begin( ), c.end( ) );
+                std::iter_swap( lemma.begin( ), std::find( lemma.begin( ), lemma.end( ), r.pivot ) );
+                if ( ! RUP( lemma ) && ! RAT( lemma ) ) { return false; }
+            }
+            return true;
+        }
+        bool check( const std::vector< DRAT_step > & proof )
+        {
+            for ( const DRAT_step & s : proof ) { step( s ); }
+            return verify( );
+        }
+    };
+    bool check_DRAT( const std::vector< std::vector< literal_code > > & formula, const std::vector< DRAT_step > & proof )
+    {
+        DRAT_checker checker;
+        checker.add_formula( formula );
+        return checker.check( proof );
+    }
+    struct DRAT_formula_reader
+    {
+        std::vector< std::vector< literal_code > > & formula;
+        void header( const DIMACS_header & ) { }
+        void clause( const std::vector< int64_t > & c )
+        {
+            std::vector< literal_code > lits;
+            for ( int64_t n : c ) { lits.push_back( encode_literal( static_cast< uint32_t >( std::abs( n ) - 1 ), n > 0 ) ); }
+            formula.push_back( std::move( lits ) );
+        }
+    };
+    bool check_DRAT( std::istream & cnf, std::istream & proof )
+    {
+        std::vector< std::vector< literal_code > > formula;
+        DIMACS_parser< DRAT_formula_reader > parser( DRAT_formula_reader { formula } );
+        std::vector< char > buffer( 1 << 16 );
+        while ( cnf )
+        {
+            cnf.read( buffer.data( ), static_cast< std::streamsize >( buffer.size( ) ) );
+            parser.feed( buffer.data( ), buffer.data( ) + cnf.gcount( ) );
+        }
+        parser.finish( );
+        DRAT_checker checker;
+        checker.add_formula( formula );
+        parse_binary_DRAT(
+            std::istreambuf_iterator< char >( proof ),
+            std::istreambuf_iterator< char >( ),
+            common::make_function_output_iterator( [&]( const DRAT_step & s ) { checker.step( s ); } ) );
+        return checker.verify( );
+    }
+}
+#endif //FIRST_ORDER_LOGIC_SAT_DRAT_CHECKER_HPP
@@ -2,73 +2,193 @@
 #define FIRST_ORDER_LOGIC_SAT_WALKSAT_HPP
 #include <random>
 #include <iterator>
+#include <map>
+#include <cmath>
+#include <vector>
+#include <algorithm>
 #include "satisfiability.hpp"
+#include "local_search.hpp"
+#include "bit_parallel.hpp"
 namespace first_order_logic
 {
+    template< typename T, typename RD >
+    satisfiability WALKSAT(
+        const std::list< std::list< literal > > & cnf, double p, T max_count, RD & rd, std::map< atomic_sentence, bool > & model )
+    {
+        local_search_state state( cnf );
+        state.scored = true;
+        state.randomise( rd );
+        if ( state.empty_clause ) { return satisfiability::unsatisfiable; }
+        while ( max_count > 0 )
+        {
+            if ( state.unsat.empty( ) ) { break; }
+            --max_count;
+            if ( p > std::uniform_real_distribution<>( 0, 1 )( rd ) )
+            { state.flip( std::uniform_int_distribution< uint32_t >( 0, state.num_variables( ) - 1 )( rd ) ); }
+            else { state.flip( state.best_variable( ) ); }
+        }
+        if ( ! state.unsat.empty( ) ) { return satisfiability::unknown; }
+        model = state.encoding.decode( state.assignment );
+        return satisfiability::satisfiable;
+    }
     template< typename T, typename RD >
     satisfiability WALKSAT( const std::list< std::list< literal > > & cnf, double p, T max_count, RD & rd )
     {
-        std::map< atomic_sentence, bool > ass;
-        for ( const auto & cl : cnf )
+        std::map< atomic_sentence, bool > model;
+        return WALKSAT( cnf, p, max_count, rd, model );
+    }
+
+    struct focused_walk_config
+    {
+        enum class strategy { WALKSAT, probSAT_polynomial, probSAT_exponential };
+        strategy pick = strategy::WALKSAT;
+        double noise = 0.567;
+        double cb = 2.38;
+        double eps = 1;
+    };
+    template< typename RD >
+    uint32_t focused_pick( const local_search_state & state, const focused_walk_config & config, RD & rd )
+    {
+        const_clause_view c = state.arena[state.clauses[state.unsat[std::uniform_int_distribution< size_t >( 0, state.unsat.size( ) - 1 )( rd )]]];
+        if ( config.pick == focused_walk_config::strategy::WALKSAT )
         {
-            for ( const literal & l : cl )
-            {
-                if ( ass.count( l.as ) == 0 )
-                { ass.insert( { l.as, std::uniform_int_distribution<>( 0, 1 )( rd ) } ); }
-            }
+            uint32_t best = literal_variable( c[0] );
+            for ( literal_code l : c ) { if ( state.break_count[literal_variable( l )] < state.break_count[best] ) { best = literal_variable( l ); } }
+            if ( state.break_count[best] == 0 || std::uniform_real_distribution<>( 0, 1 )( rd ) >= config.noise ) { return best; }
+            return literal_variable( c[std::uniform_int_distribution< size_t >( 0, c.size( ) - 1 )( rd )] );
+        }
+        std::vector< double > weight;
+        weight.reserve( c.size( ) );
+        for ( literal_code l : c )
+        {
+            double b = state.break_count[literal_variable( l )];
+            weight.push_back(
+                config.pick == focused_walk_config::strategy::probSAT_polynomial ?
+                    std::pow( config.eps + b, - config.cb ) : std::pow( config.cb, - b ) );
         }
-        if ( ass.empty( ) ) { return satisfiability::satisfiable; }
-        auto conflict_number =
-            [&]( )->size_t
+        return literal_variable( c[std::discrete_distribution< size_t >( weight.begin( ), weight.end( ) )( rd )] );
+    }
+    template< typename T, typename RD >
+    satisfiability focused_random_walk( local_search_state & state, const focused_walk_config & config, T max_count, RD & rd )
+    {
+        if ( state.empty_clause ) { return satisfiability::unsatisfiable; }
+        while ( ! state.unsat.empty( ) && max_count > 0 )
+        {
+            --max_count;
+            state.flip( focused_pick( state, config, rd ) );
+        }
+        return state.unsat.empty( ) ? satisfiability::satisfiable : satisfiability::unknown;
+    }
+    struct multi_try_config
+    {
+        size_t max_tries = 10;
+        size_t max_flips = 100000;
+        uint64_t seed = 0;
+        bool adaptive_noise = true;
+        double theta = 1.0 / 6;
+        double phi = 0.2;
+        bool best_start = false;
+        focused_walk_config walk;
+    };
+    inline uint64_t derive_seed( uint64_t seed, uint64_t index )
+    {
+        uint64_t z = seed + ( index + 1 ) * 0x9e3779b97f4a7c15;
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111eb;
+        return z ^ ( z >> 31 );
+    }
+    template< typename RD >
+    satisfiability adaptive_random_walk( local_search_state & state, const multi_try_config & config, RD & rd )
+    {
+        if ( state.empty_clause ) { return satisfiability::unsatisfiable; }
+        focused_walk_config walk = config.walk;
+        walk.noise = 0;
+        auto adapt =
+            [&]( )
             {
-                return std::accumulate(
-                    cnf.begin( ),
-                    cnf.end( ),
-                    static_cast< size_t >( 0 ),
-                    [&]( size_t s, const auto & cl )->size_t
-                    {
-                        return
-                            s +
-                            (std::any_of(
-                                cl.begin( ),
-                                cl.end( ),
-                                [&]( const literal & l )
-                                {
-                                    auto it = ass.find( l.as );
-                                    assert( it != ass.end( ) );
-                                    return it->second == l.b;
-                                } ) ? 0 : 1);
-                    } );
+                if ( walk.pick == focused_walk_config::strategy::probSAT_polynomial )
+                { walk.cb = config.walk.cb * ( 1 - walk.noise ); }
+                else if ( walk.pick == focused_walk_config::strategy::probSAT_exponential )
+                { walk.cb = 1 + ( config.walk.cb - 1 ) * ( 1 - walk.noise ); }
             };
-        while ( max_count > 0 )
+        size_t window = std::max< size_t >( 1, static_cast< size_t >( config.theta * state.clauses.size( ) ) );
+        size_t last_unsat = state.unsat.size( ), last_change = 0;
+        for ( size_t flip = 0; ! state.unsat.empty( ) && flip < config.max_flips; ++flip )
         {
-            if ( conflict_number( ) == 0 ) { return satisfiability::satisfiable; }
-            --max_count;
-            if ( p > std::uniform_real_distribution<>( 0, 1 )( rd ) )
+            state.flip( focused_pick( state, walk, rd ) );
+            if ( state.unsat.size( ) < last_unsat )
             {
-                auto it = ass.begin( );
-                std::advance( it, std::uniform_int_distribution<>( 0, ass.size( ) - 1 )( rd ) );
-                it->second = ! it->second;
+                walk.noise -= walk.noise * config.phi / 2;
+                adapt( );
+                last_unsat = state.unsat.size( );
+                last_change = flip;
             }
-            else
+            else if ( flip - last_change > window )
+            {
+                walk.noise += ( 1 - walk.noise ) * config.phi;
+                adapt( );
+                last_unsat = state.unsat.size( );
+                last_change = flip;
+            }
+        }
+        return state.unsat.empty( ) ? satisfiability::satisfiable : satisfiability::unknown;
+    }
+    satisfiability multi_try_WALKSAT(
+        const std::list< std::list< literal > > & cnf,
+        const multi_try_config & config,
+        std::map< atomic_sentence, bool > & model )
+    {
+        local_search_state state( cnf );
+        if ( state.empty_clause ) { return satisfiability::unsatisfiable; }
+        for ( size_t i = 0; i < config.max_tries; ++i )
+        {
+            std::mt19937_64 rd( derive_seed( config.seed, i ) );
+            if ( config.best_start ) { best_random_start( state, rd ); }
+            else { state.randomise( rd ); }
+            satisfiability ret =
+                config.adaptive_noise ?
+                    adaptive_random_walk( state, config, rd ) :
+                    focused_random_walk( state, config.walk, config.max_flips, rd );
+            if ( ret == satisfiability::satisfiable )
             {
-                std::map< atomic_sentence, size_t > flip_value;
-                for ( auto it = ass.begin( ); it != ass.end( ); ++it )
-                {
-                    it->second = ! it->second;
-                    flip_value.insert( std::make_pair( it->first, conflict_number( ) ) );
-                    it->second = ! it->second;
-                }
-                assert( flip_value.size( ) == ass.size( ) );
-                auto it = std::min_element(
-                            flip_value.begin( ),
-                            flip_value.end( ),
-                            []( const std::pair< atomic_sentence, size_t > & l,
-                                const std::pair< atomic_sentence, size_t > & r ) { return l.second < r.second; } );
-                it->second = ! it->second;
+                model = state.encoding.decode( state.assignment );
+                return ret;
             }
         }
-        return satisfiability::unsatisfiable;
+        return satisfiability::unknown;
+    }
+    satisfiability multi_try_WALKSAT( const std::list< std::list< literal > > & cnf, const multi_try_config & config = multi_try_config( ) )
+    {
+        std::map< atomic_sentence, bool > model;
+        return multi_try_WALKSAT( cnf, config, model );
+    }
+    template< typename T, typename RD >
+    satisfiability focused_WALKSAT(
+        const std::list< std::list< literal > > & cnf,
+        const focused_walk_config & config,
+        T max_count,
+        RD & rd,
+        std::map< atomic_sentence, bool > & model )
+    {
+        local_search_state state( cnf );
+        state.randomise( rd );
+        satisfiability ret = focused_random_walk( state, config, max_count, rd );
+        if ( ret == satisfiability::satisfiable ) { model = state.encoding.decode( state.assignment ); }
+        return ret;
+    }
+    template< typename T, typename RD >
+    satisfiability focused_WALKSAT(
+        const std::list< std::list< literal > > & cnf, double p, T max_count, RD & rd, std::map< atomic_sentence, bool > & model )
+    {
+        focused_walk_config config;
+        config.noise = p;
+        return focused_WALKSAT( cnf, config, max_count, rd, model );
+    }
+    template< typename T, typename RD >
+    satisfiability focused_WALKSAT( const std::list< std::list< literal > > & cnf, double p, T max_count, RD & rd )
+    {
+        std::map< atomic_sentence, bool > model;
+        return focused_WALKSAT( cnf, p, max_count, rd, model );
     }
 }
 #endif //FIRST_ORDER_LOGIC_SAT_WALKSAT_HPP
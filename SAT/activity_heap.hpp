@@ -0,0 +1,88 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_ACTIVITY_HEAP_HPP
+#define FIRST_ORDER_LOGIC_SAT_ACTIVITY_HEAP_HPP
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+namespace first_order_logic
+{
+    struct activity_heap
+    {
+        enum : uint32_t { absent = std::numeric_limits< uint32_t >::max( ) };
+        std::vector< double > activity;
+        std::vector< uint32_t > heap, index;
+        bool empty( ) const { return heap.empty( ); }
+        size_t size( ) const { return heap.size( ); }
+        bool contains( uint32_t v ) const { return v < index.size( ) && index[v] != absent; }
+        bool before( uint32_t a, uint32_t b ) const { return activity[a] > activity[b]; }
+        void place( size_t pos, uint32_t v )
+        {
+            heap[pos] = v;
+            index[v] = static_cast< uint32_t >( pos );
+        }
+        void up( size_t pos )
+        {
+            uint32_t v = heap[pos];
+            while ( pos > 0 && before( v, heap[( pos - 1 ) / 2] ) )
+            {
+                place( pos, heap[( pos - 1 ) / 2] );
+                pos = ( pos - 1 ) / 2;
+            }
+            place( pos, v );
+        }
+        void down( size_t pos )
+        {
+            uint32_t v = heap[pos];
+            while ( pos * 2 + 1 < heap.size( ) )
+            {
+                size_t child = pos * 2 + 1;
+                if ( child + 1 < heap.size( ) && before( heap[child + 1], heap[child] ) ) { ++child; }
+                if ( ! before( heap[child], v ) ) { break; }
+                place( pos, heap[child] );
+                pos = child;
+            }
+            place( pos, v );
+        }
+        void grow( size_t n )
+        {
+            if ( activity.size( ) < n )
+            {
+                activity.resize( n, 0 );
+                index.resize( n, absent );
+            }
+        }
+        void insert( uint32_t v )
+        {
+            grow( v + 1 );
+            if ( contains( v ) ) { return; }
+            heap.push_back( v );
+            index[v] = static_cast< uint32_t >( heap.size( ) - 1 );
+            up( heap.size( ) - 1 );
+        }
+        uint32_t pop( )
+        {
+            assert( ! heap.empty( ) );
+            uint32_t ret = heap[0];
+            index[ret] = absent;
+            uint32_t last = heap.back( );
+            heap.pop_back( );
+            if ( ! heap.empty( ) )
+            {
+                place( 0, last );
+                down( 0 );
+            }
+            return ret;
+        }
+        bool bump( uint32_t v, double inc )
+        {
+            grow( v + 1 );
+            activity[v] += inc;
+            if ( contains( v ) ) { up( index[v] ); }
+            return activity[v] > 1e100;
+        }
+        void rescale( double factor )
+        { for ( double & a : activity ) { a *= factor; } }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_ACTIVITY_HEAP_HPP
@@ -0,0 +1,164 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_BIT_PARALLEL_HPP
+#define FIRST_ORDER_LOGIC_SAT_BIT_PARALLEL_HPP
+#include <map>
+#include <list>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "../satisfiability.hpp"
+#include "encoding.hpp"
+#include "clause_arena.hpp"
+#include "local_search.hpp"
+namespace first_order_logic
+{
+    template< size_t WORDS >
+    struct bit_block
+    {
+        uint64_t word[WORDS];
+        static bit_block zero( )
+        {
+            bit_block ret;
+            std::fill( ret.word, ret.word + WORDS, 0 );
+            return ret;
+        }
+        enum class operation { conjunction, disjunction, exclusive };
+        static uint64_t apply( operation op, uint64_t l, uint64_t r )
+        { return op == operation::conjunction ? l & r : op == operation::disjunction ? l | r : l ^ r; }
+#ifdef __AVX2__
+        static __m256i apply( operation op, __m256i l, __m256i r )
+        {
+            return
+                op == operation::conjunction ? _mm256_and_si256( l, r ) :
+                op == operation::disjunction ? _mm256_or_si256( l, r ) : _mm256_xor_si256( l, r );
+        }
+#endif
+        bit_block combine( const bit_block & b, operation op ) const
+        {
+            bit_block ret;
+            size_t i = 0;
+#ifdef __AVX2__
+            for ( ; i + 4 <= WORDS; i += 4 )
+            {
+                _mm256_storeu_si256(
+                    reinterpret_cast< __m256i * >( ret.word + i ),
+                    apply(
+                        op,
+                        _mm256_loadu_si256( reinterpret_cast< const __m256i * >( word + i ) ),
+                        _mm256_loadu_si256( reinterpret_cast< const __m256i * >( b.word + i ) ) ) );
+            }
+#endif
+            for ( ; i < WORDS; ++i ) { ret.word[i] = apply( op, word[i], b.word[i] ); }
+            return ret;
+        }
+        bit_block operator & ( const bit_block & b ) const { return combine( b, operation::conjunction ); }
+        bit_block operator | ( const bit_block & b ) const { return combine( b, operation::disjunction ); }
+        bit_block operator ^ ( const bit_block & b ) const { return combine( b, operation::exclusive ); }
+        bit_block operator ~ ( ) const
+        {
+            bit_block ret;
+            for ( size_t i = 0; i < WORDS; ++i ) { ret.word[i] = ~ word[i]; }
+            return ret;
+        }
+        bool none( ) const { return std::all_of( word, word + WORDS, []( uint64_t w ) { return w == 0; } ); }
+        bool test( size_t i ) const { return ( word[i / 64] >> ( i % 64 ) & 1 ) != 0; }
+        void set( size_t i, bool b )
+        {
+            if ( b ) { word[i / 64] |= uint64_t( 1 ) << ( i % 64 ); }
+            else { word[i / 64] &= ~( uint64_t( 1 ) << ( i % 64 ) ); }
+        }
+    };
+    template< size_t WORDS = 1 >
+    struct bit_parallel_evaluator
+    {
+        typedef bit_block< WORDS > block;
+        enum : size_t { lanes = 64 * WORDS };
+        const clause_arena & arena;
+        const std::vector< clause_ref > & clauses;
+        std::vector< block > assignment;
+        bit_parallel_evaluator( const clause_arena & arena, const std::vector< clause_ref > & clauses, size_t variables ) :
+            arena( arena ), clauses( clauses ), assignment( variables, block::zero( ) ) { }
+        template< typename RD >
+        void randomise( RD & rd )
+        {
+            std::uniform_int_distribution< uint64_t > bits;
+            for ( block & b : assignment ) { for ( uint64_t & w : b.word ) { w = bits( rd ); } }
+        }
+        bool get( size_t lane, uint32_t v ) const { return assignment[v].test( lane ); }
+        void set( size_t lane, uint32_t v, bool b ) { assignment[v].set( lane, b ); }
+        block satisfied( clause_ref c ) const
+        {
+            block ret = block::zero( );
+            for ( literal_code l : arena[c] )
+            {
+                const block & x = assignment[literal_variable( l )];
+                ret = ret | ( literal_sign( l ) ? x : ~ x );
+            }
+            return ret;
+        }
+        block satisfied( ) const
+        {
+            block ret = ~ block::zero( );
+            for ( clause_ref c : clauses )
+            {
+                ret = ret & satisfied( c );
+                if ( ret.none( ) ) { break; }
+            }
+            return ret;
+        }
+        std::vector< size_t > unsat_counts( ) const
+        {
+            std::vector< block > planes;
+            for ( clause_ref c : clauses )
+            {
+                block carry = ~ satisfied( c );
+                for ( size_t i = 0; ! carry.none( ); ++i )
+                {
+                    if ( i == planes.size( ) ) { planes.push_back( block::zero( ) ); }
+                    block next = planes[i] & carry;
+                    planes[i] = planes[i] ^ carry;
+                    carry = next;
+                }
+            }
+            std::vector< size_t > ret( lanes, 0 );
+            for ( size_t i = 0; i < planes.size( ); ++i )
+            { for ( size_t j = 0; j < lanes; ++j ) { if ( planes[i].test( j ) ) { ret[j] |= size_t( 1 ) << i; } } }
+            return ret;
+        }
+    };
+    template< size_t WORDS = 4, typename RD >
+    size_t best_random_start( local_search_state & state, RD & rd )
+    {
+        bit_parallel_evaluator< WORDS > evaluator( state.arena, state.clauses, state.num_variables( ) );
+        evaluator.randomise( rd );
+        std::vector< size_t > counts = evaluator.unsat_counts( );
+        size_t best = std::min_element( counts.begin( ), counts.end( ) ) - counts.begin( );
+        for ( uint32_t v = 0; v < state.num_variables( ); ++v ) { state.assignment[v] = evaluator.get( best, v ); }
+        state.initialise( );
+        return counts[best];
+    }
+    template< size_t WORDS = 4, typename RD >
+    satisfiability random_screen(
+        const std::list< std::list< literal > > & cnf, size_t rounds, RD & rd, std::map< atomic_sentence, bool > & model )
+    {
+        local_search_state state( cnf );
+        if ( state.empty_clause ) { return satisfiability::unsatisfiable; }
+        bit_parallel_evaluator< WORDS > evaluator( state.arena, state.clauses, state.num_variables( ) );
+        for ( size_t i = 0; i < rounds; ++i )
+        {
+            evaluator.randomise( rd );
+            auto satisfied = evaluator.satisfied( );
+            if ( satisfied.none( ) ) { continue; }
+            size_t lane = 0;
+            while ( ! satisfied.test( lane ) ) { ++lane; }
+            for ( uint32_t v = 0; v < state.num_variables( ); ++v ) { state.assignment[v] = evaluator.get( lane, v ); }
+            model = state.encoding.decode( state.assignment );
+            return satisfiability::satisfiable;
+        }
+        return satisfiability::unknown;
+    }
+}
+#endif //FIRST_ORDER_LOGIC_SAT_BIT_PARALLEL_HPP
@@ -0,0 +1,72 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_BUFFERED_WRITER_HPP
+#define FIRST_ORDER_LOGIC_SAT_BUFFERED_WRITER_HPP
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <ostream>
+#include <condition_variable>
+namespace first_order_logic
+{
+    struct buffered_writer
+    {
+        std::ostream & os;
+        size_t buffer_size;
+        std::vector< char > buffer, pending;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool writing = false, stop = false;
+        std::thread worker;
+        explicit buffered_writer( std::ostream & os, size_t buffer_size = 1 << 20 ) :
+            os( os ), buffer_size( buffer_size ), worker( [this]( ) { run( ); } ) { buffer.reserve( buffer_size ); }
+        buffered_writer( const buffered_writer & ) = delete;
+        buffered_writer & operator = ( const buffered_writer & ) = delete;
+        ~buffered_writer( )
+        {
+            hand_off( );
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+                stop = true;
+            }
+            cv.notify_all( );
+            worker.join( );
+            os.flush( );
+        }
+        void run( )
+        {
+            std::vector< char > local;
+            std::unique_lock< std::mutex > lock( mutex );
+            while ( true )
+            {
+                cv.wait( lock, [&]( ) { return stop || ! pending.empty( ); } );
+                if ( pending.empty( ) ) { return; }
+                local.swap( pending );
+                writing = true;
+                lock.unlock( );
+                os.write( local.data( ), static_cast< std::streamsize >( local.size( ) ) );
+                local.clear( );
+                lock.lock( );
+                writing = false;
+                cv.notify_all( );
+            }
+        }
+        void hand_off( )
+        {
+            if ( buffer.empty( ) ) { return; }
+            {
+                std::unique_lock< std::mutex > lock( mutex );
+                cv.wait( lock, [&]( ) { return pending.empty( ); } );
+                pending.swap( buffer );
+            }
+            cv.notify_all( );
+            buffer.reserve( buffer_size );
+        }
+        void flush( )
+        {
+            hand_off( );
+            std::unique_lock< std::mutex > lock( mutex );
+            cv.wait( lock, [&]( ) { return pending.empty( ) && ! writing; } );
+            os.flush( );
+        }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_BUFFERED_WRITER_HPP
@@ -0,0 +1,86 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_CLAUSE_ARENA_HPP
+#define FIRST_ORDER_LOGIC_SAT_CLAUSE_ARENA_HPP
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+#include <cstring>
+#include "encoding.hpp"
+namespace first_order_logic
+{
+    typedef uint32_t clause_ref;
+    template< typename WORD >
+    struct basic_clause_view
+    {
+        WORD * base;
+        enum : uint32_t
+        { header_size = 3, learnt_flag = 1, deleted_flag = 2, used_flag = 4, relocated_flag = 8, flag_bits = 4 };
+        explicit basic_clause_view( WORD * base ) : base( base ) { }
+        template< typename W >
+        basic_clause_view( const basic_clause_view< W > & v ) : base( v.base ) { }
+        uint32_t size( ) const { return base[0]; }
+        bool learnt( ) const { return ( base[1] & learnt_flag ) != 0; }
+        bool deleted( ) const { return ( base[1] & deleted_flag ) != 0; }
+        bool used( ) const { return ( base[1] & used_flag ) != 0; }
+        bool relocated( ) const { return ( base[1] & relocated_flag ) != 0; }
+        uint32_t LBD( ) const { return base[1] >> flag_bits; }
+        float activity( ) const
+        {
+            float ret;
+            std::memcpy( & ret, base + 2, sizeof( ret ) );
+            return ret;
+        }
+        void set_used( bool u ) const { base[1] = u ? base[1] | used_flag : base[1] & ~ uint32_t( used_flag ); }
+        void set_LBD( uint32_t lbd ) const { base[1] = ( base[1] & ( ( 1u << flag_bits ) - 1 ) ) | ( lbd << flag_bits ); }
+        void set_activity( float a ) const { std::memcpy( base + 2, & a, sizeof( a ) ); }
+        WORD & operator [ ]( size_t i ) const { return base[header_size + i]; }
+        WORD * begin( ) const { return base + header_size; }
+        WORD * end( ) const { return base + header_size + size( ); }
+    };
+    typedef basic_clause_view< literal_code > clause_view;
+    typedef basic_clause_view< const literal_code > const_clause_view;
+    struct clause_arena
+    {
+        enum : clause_ref { no_clause = std::numeric_limits< clause_ref >::max( ) };
+        std::vector< uint32_t > data;
+        size_t wasted = 0;
+        template< typename INITER >
+        clause_ref alloc( INITER begin, INITER end, bool learnt = false, uint32_t LBD = 0 )
+        {
+            clause_ref ret = static_cast< clause_ref >( data.size( ) );
+            data.push_back( 0 );
+            data.push_back( ( learnt ? uint32_t( clause_view::learnt_flag ) : 0u ) | ( LBD << clause_view::flag_bits ) );
+            data.push_back( 0 );
+            data.insert( data.end( ), begin, end );
+            data[ret] = static_cast< uint32_t >( data.size( ) - ret - clause_view::header_size );
+            return ret;
+        }
+        clause_view operator [ ]( clause_ref c ) { return clause_view( data.data( ) + c ); }
+        const_clause_view operator [ ]( clause_ref c ) const { return const_clause_view( data.data( ) + c ); }
+        void free( clause_ref c )
+        {
+            assert( ! (*this)[c].deleted( ) );
+            data[c + 1] |= clause_view::deleted_flag;
+            wasted += clause_view::header_size + data[c];
+        }
+        void shrink( clause_ref c, uint32_t size )
+        {
+            assert( size <= data[c] );
+            wasted += data[c] - size;
+            data[c] = size;
+        }
+        clause_ref relocate( clause_ref c, clause_arena & to )
+        {
+            clause_view v = (*this)[c];
+            assert( ! v.deleted( ) );
+            if ( v.relocated( ) ) { return data[c + 2]; }
+            clause_ref ret = static_cast< clause_ref >( to.data.size( ) );
+            to.data.insert( to.data.end( ), data.begin( ) + c, data.begin( ) + c + clause_view::header_size + v.size( ) );
+            data[c + 1] |= clause_view::relocated_flag;
+            data[c + 2] = ret;
+            return ret;
+        }
+        size_t size( ) const { return data.size( ); }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_CLAUSE_ARENA_HPP
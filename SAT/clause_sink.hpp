@@ -0,0 +1,147 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_CLAUSE_SINK_HPP
+#define FIRST_ORDER_LOGIC_SAT_CLAUSE_SINK_HPP
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <functional>
+#include <experimental/optional>
+#include "encoding.hpp"
+#include "clause_arena.hpp"
+#include "buffered_writer.hpp"
+#include "CDCL.hpp"
+#include "../cpp_common/iterator.hpp"
+namespace first_order_logic
+{
+    template< typename PRODUCER, typename SINK >
+    SINK & stream_clauses( PRODUCER produce, variable_encoding & encoding, SINK & sink )
+    {
+        std::vector< literal_code > clause;
+        produce(
+            common::make_function_output_iterator(
+                [&]( const std::experimental::optional< literal > & l )
+                {
+                    if ( l )
+                    {
+                        clause.push_back( encoding( l.value( ) ) );
+                        return;
+                    }
+                    sink.clause( static_cast< const std::vector< literal_code > & >( clause ) );
+                    clause.clear( );
+                } ) );
+        return sink;
+    }
+
+    struct arena_clause_sink
+    {
+        clause_arena & arena;
+        std::vector< clause_ref > & clauses;
+        size_t capacity;
+        std::function< void( const clause_arena &, const std::vector< clause_ref > & ) > drain;
+        arena_clause_sink( clause_arena & arena, std::vector< clause_ref > & clauses ) :
+            arena( arena ), clauses( clauses ), capacity( std::numeric_limits< size_t >::max( ) ) { }
+        arena_clause_sink(
+            clause_arena & arena,
+            std::vector< clause_ref > & clauses,
+            size_t capacity,
+            const std::function< void( const clause_arena &, const std::vector< clause_ref > & ) > & drain ) :
+            arena( arena ), clauses( clauses ), capacity( capacity ), drain( drain ) { }
+        void clause( const std::vector< literal_code > & c )
+        {
+            clauses.push_back( arena.alloc( c.begin( ), c.end( ) ) );
+            if ( arena.size( ) >= capacity ) { finish( ); }
+        }
+        void finish( )
+        {
+            if ( ! drain || clauses.empty( ) ) { return; }
+            drain( arena, clauses );
+            arena.data.clear( );
+            arena.wasted = 0;
+            clauses.clear( );
+        }
+    };
+
+    struct CDCL_clause_sink
+    {
+        CDCL_solver & solver;
+        explicit CDCL_clause_sink( CDCL_solver & solver ) : solver( solver ) { }
+        void clause( const std::vector< literal_code > & c ) { solver.add_clause( c ); }
+        void finish( ) { }
+    };
+
+    template< typename PRODUCER >
+    bool stream_clauses( PRODUCER produce, CDCL_solver & solver )
+    {
+        CDCL_clause_sink sink( solver );
+        stream_clauses( produce, solver.encoding, sink );
+        return ! solver.inconsistent;
+    }
+
+    struct DIMACS_clause_sink : buffered_writer
+    {
+        enum : size_t { header_width = 48 };
+        const variable_encoding * names;
+        std::streampos header;
+        size_t variables = 0, clauses = 0, named = 0;
+        bool finished = false;
+        explicit DIMACS_clause_sink(
+            std::ostream & os, const variable_encoding * names = nullptr, size_t buffer_size = 1 << 20 ) :
+            buffered_writer( os, buffer_size ), names( names ), header( os.tellp( ) )
+        {
+            if ( header == std::streampos( -1 ) ) { throw std::invalid_argument( "DIMACS: clause sink needs a seekable stream" ); }
+            buffer.insert( buffer.end( ), header_width - 1, ' ' );
+            buffer.push_back( '\n' );
+        }
+        ~DIMACS_clause_sink( ) { finish( ); }
+        void append( uint64_t n )
+        {
+            char digits[20];
+            size_t size = 0;
+            do
+            {
+                digits[size++] = static_cast< char >( '0' + n % 10 );
+                n /= 10;
+            }
+            while ( n != 0 );
+            while ( size != 0 ) { buffer.push_back( digits[--size] ); }
+        }
+        void clause( const std::vector< literal_code > & c )
+        {
+            for ( ; names != nullptr && named < names->size( ); ++named )
+            {
+                const std::string & atom = static_cast< const std::string & >( names->atom( static_cast< uint32_t >( named ) ) );
+                buffer.insert( buffer.end( ), { 'c', ' ' } );
+                append( named + 1 );
+                buffer.push_back( ' ' );
+                buffer.insert( buffer.end( ), atom.begin( ), atom.end( ) );
+                buffer.push_back( '\n' );
+            }
+            for ( literal_code l : c )
+            {
+                if ( literal_variable( l ) >= variables ) { variables = literal_variable( l ) + 1; }
+                if ( ! literal_sign( l ) ) { buffer.push_back( '-' ); }
+                append( literal_variable( l ) + 1 );
+                buffer.push_back( ' ' );
+            }
+            buffer.insert( buffer.end( ), { '0', '\n' } );
+            ++clauses;
+            if ( buffer.size( ) >= buffer_size ) { hand_off( ); }
+        }
+        void finish( )
+        {
+            if ( finished ) { return; }
+            finished = true;
+            flush( );
+            std::string line = "p cnf " + std::to_string( variables ) + " " + std::to_string( clauses );
+            line.resize( header_width - 1, ' ' );
+            std::streampos end = os.tellp( );
+            os.seekp( header );
+            os << line << '\n';
+            os.seekp( end );
+            os.flush( );
+        }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_CLAUSE_SINK_HPP
@@ -0,0 +1,223 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_CUBE_AND_CONQUER_HPP
+#define FIRST_ORDER_LOGIC_SAT_CUBE_AND_CONQUER_HPP
+#include <map>
+#include <list>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <experimental/optional>
+#include "../satisfiability.hpp"
+#include "CDCL.hpp"
+namespace first_order_logic
+{
+    struct cube_config
+    {
+        size_t depth = 8;
+        size_t candidates = 32;
+        size_t threads = std::max< size_t >( std::thread::hardware_concurrency( ), 1 );
+        CDCL_config solver;
+    };
+    struct lookahead_cuber
+    {
+        CDCL_solver & solver;
+        const cube_config & config;
+        std::vector< size_t > occurrences;
+        std::vector< CDCL_solver::lit > prefix;
+        lookahead_cuber( CDCL_solver & solver, const cube_config & config ) :
+            solver( solver ), config( config ), occurrences( solver.num_variables( ), 0 )
+        {
+            for ( clause_ref c : solver.clauses )
+            { for ( CDCL_solver::lit l : solver.arena[c] ) { ++occurrences[CDCL_solver::var( l )]; } }
+        }
+        std::experimental::optional< size_t > probe( CDCL_solver::lit l )
+        {
+            size_t level = solver.decision_level( );
+            bool consistent = solver.assume( l );
+            size_t implied = solver.trail.size( ) - solver.trail_lim.back( );
+            solver.backtrack( level );
+            return consistent ? implied : std::experimental::optional< size_t >( );
+        }
+        bool extend( CDCL_solver::lit l )
+        {
+            if ( ! solver.assume( l ) ) { return false; }
+            prefix.push_back( l );
+            return true;
+        }
+        template< typename OUTITER >
+        OUTITER operator ( )( size_t depth, OUTITER out )
+        {
+            size_t level = solver.decision_level( ), size = prefix.size( );
+            auto restore =
+                [&]( )
+                {
+                    solver.backtrack( level );
+                    prefix.resize( size );
+                };
+            while ( true )
+            {
+                std::vector< uint32_t > candidates;
+                for ( uint32_t v = 0; v < solver.num_variables( ); ++v )
+                { if ( solver.assigns[v] == 0 && occurrences[v] > 0 ) { candidates.push_back( v ); } }
+                if ( candidates.empty( ) || depth >= config.depth )
+                {
+                    * out = prefix;
+                    ++out;
+                    restore( );
+                    return out;
+                }
+                if ( candidates.size( ) > config.candidates )
+                {
+                    std::partial_sort(
+                        candidates.begin( ),
+                        candidates.begin( ) + config.candidates,
+                        candidates.end( ),
+                        [&]( uint32_t l, uint32_t r ) { return occurrences[l] > occurrences[r]; } );
+                    candidates.resize( config.candidates );
+                }
+                std::experimental::optional< uint32_t > best;
+                size_t best_score = 0;
+                std::experimental::optional< CDCL_solver::lit > forced;
+                for ( uint32_t v : candidates )
+                {
+                    auto positive = probe( CDCL_solver::make_lit( v, true ) ), negative = probe( CDCL_solver::make_lit( v, false ) );
+                    if ( ! positive && ! negative )
+                    {
+                        restore( );
+                        return out;
+                    }
+                    if ( ! positive || ! negative )
+                    {
+                        forced = CDCL_solver::make_lit( v, static_cast< bool >( positive ) );
+                        break;
+                    }
+                    size_t score = ( * positive + 1 ) * ( * negative + 1 );
+                    if ( ! best || score > best_score )
+                    {
+                        best = v;
+                        best_score = score;
+                    }
+                }
+                if ( forced )
+                {
+                    if ( ! extend( * forced ) )
+                    {
+                        restore( );
+                        return out;
+                    }
+                    continue;
+                }
+                for ( bool b : { true, false } )
+                {
+                    size_t branch_level = solver.decision_level( ), branch_size = prefix.size( );
+                    if ( extend( CDCL_solver::make_lit( * best, b ) ) ) { out = (*this)( depth + 1, out ); }
+                    solver.backtrack( branch_level );
+                    prefix.resize( branch_size );
+                }
+                restore( );
+                return out;
+            }
+        }
+    };
+    template< typename OUTITER >
+    OUTITER lookahead_cubes( CDCL_solver & solver, const cube_config & config, OUTITER out )
+    {
+        if ( solver.inconsistent || solver.propagate( ) != CDCL_solver::no_reason ) { return out; }
+        lookahead_cuber cuber( solver, config );
+        return cuber( 0, out );
+    }
+    struct work_stealing_queue
+    {
+        typedef std::vector< CDCL_solver::lit > cube;
+        std::vector< std::deque< cube > > queues;
+        std::vector< std::mutex > mutexes;
+        explicit work_stealing_queue( size_t workers ) : queues( workers ), mutexes( workers ) { }
+        void push( size_t worker, cube c )
+        {
+            std::lock_guard< std::mutex > lock( mutexes[worker] );
+            queues[worker].push_back( std::move( c ) );
+        }
+        std::experimental::optional< cube > pop( size_t worker )
+        {
+            for ( size_t i = 0; i < queues.size( ); ++i )
+            {
+                size_t victim = ( worker + i ) % queues.size( );
+                std::lock_guard< std::mutex > lock( mutexes[victim] );
+                if ( queues[victim].empty( ) ) { continue; }
+                cube ret;
+                if ( i == 0 )
+                {
+                    ret = std::move( queues[victim].front( ) );
+                    queues[victim].pop_front( );
+                }
+                else
+                {
+                    ret = std::move( queues[victim].back( ) );
+                    queues[victim].pop_back( );
+                }
+                return ret;
+            }
+            return std::experimental::optional< cube >( );
+        }
+    };
+    satisfiability cube_and_conquer(
+        const std::list< std::list< literal > > & cnf,
+        std::map< atomic_sentence, bool > & model,
+        const cube_config & config = cube_config( ) )
+    {
+        CDCL_solver cuber_solver( config.solver );
+        for ( const auto & cl : cnf ) { if ( ! cuber_solver.add_clause( cl ) ) { return satisfiability::unsatisfiable; } }
+        std::vector< work_stealing_queue::cube > cubes;
+        lookahead_cubes( cuber_solver, config, std::back_inserter( cubes ) );
+        if ( cubes.empty( ) ) { return satisfiability::unsatisfiable; }
+        size_t threads = std::max< size_t >( std::min( config.threads, cubes.size( ) ), 1 );
+        work_stealing_queue queue( threads );
+        for ( size_t i = 0; i < cubes.size( ); ++i ) { queue.push( i % threads, std::move( cubes[i] ) ); }
+        std::atomic< bool > stop( false );
+        std::mutex mutex;
+        satisfiability ret = satisfiability::unsatisfiable;
+        std::vector< std::thread > workers;
+        for ( size_t i = 0; i < threads; ++i )
+        {
+            workers.emplace_back(
+                [&, i]( )
+                {
+                    CDCL_solver solver( config.solver );
+                    solver.interrupt = & stop;
+                    for ( const auto & cl : cnf ) { solver.add_clause( cl ); }
+                    while ( ! stop )
+                    {
+                        auto c = queue.pop( i );
+                        if ( ! c ) { return; }
+                        satisfiability result = solver.solve( * c );
+                        if ( result == satisfiability::satisfiable )
+                        {
+                            std::lock_guard< std::mutex > lock( mutex );
+                            if ( ! stop )
+                            {
+                                ret = satisfiability::satisfiable;
+                                model = solver.model_map( );
+                                stop = true;
+                            }
+                            return;
+                        }
+                        if ( result == satisfiability::unsatisfiable && solver.inconsistent )
+                        {
+                            stop = true;
+                            return;
+                        }
+                    }
+                } );
+        }
+        for ( std::thread & t : workers ) { t.join( ); }
+        return ret;
+    }
+    satisfiability cube_and_conquer( const std::list< std::list< literal > > & cnf, const cube_config & config = cube_config( ) )
+    {
+        std::map< atomic_sentence, bool > model;
+        return cube_and_conquer( cnf, model, config );
+    }
+}
+#endif //FIRST_ORDER_LOGIC_SAT_CUBE_AND_CONQUER_HPP
@@ -0,0 +1,58 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_ENCODING_HPP
+#define FIRST_ORDER_LOGIC_SAT_ENCODING_HPP
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <functional>
+#include <unordered_map>
+#include <experimental/optional>
+#include "../sentence/CNF.hpp"
+namespace first_order_logic
+{
+    typedef uint32_t literal_code;
+    inline literal_code encode_literal( uint32_t var, bool b ) { return var * 2 + ( b ? 0 : 1 ); }
+    inline uint32_t literal_variable( literal_code l ) { return l >> 1; }
+    inline bool literal_sign( literal_code l ) { return ( l & 1 ) == 0; }
+    inline literal_code negate_literal( literal_code l ) { return l ^ 1; }
+    struct atomic_sentence_hash
+    {
+        size_t operator ( )( const atomic_sentence & as ) const
+        { return std::hash< std::string >( )( static_cast< const std::string & >( as ) ); }
+    };
+    struct variable_encoding
+    {
+        std::unordered_map< atomic_sentence, uint32_t, atomic_sentence_hash > variables;
+        std::vector< atomic_sentence > atoms;
+        size_t size( ) const { return atoms.size( ); }
+        uint32_t operator ( )( const atomic_sentence & as )
+        {
+            auto it = variables.find( as );
+            if ( it != variables.end( ) ) { return it->second; }
+            uint32_t ret = static_cast< uint32_t >( atoms.size( ) );
+            atoms.push_back( as );
+            variables.insert( { as, ret } );
+            return ret;
+        }
+        literal_code operator ( )( const literal & l ) { return encode_literal( (*this)( l.as ), l.b ); }
+        std::experimental::optional< uint32_t > find( const atomic_sentence & as ) const
+        {
+            auto it = variables.find( as );
+            return it == variables.end( ) ? std::experimental::optional< uint32_t >( ) : it->second;
+        }
+        const atomic_sentence & atom( uint32_t var ) const
+        {
+            assert( var < atoms.size( ) );
+            return atoms[var];
+        }
+        literal decode( literal_code l ) const { return literal( atom( literal_variable( l ) ), literal_sign( l ) ); }
+        std::map< atomic_sentence, bool > decode( const std::vector< bool > & model ) const
+        {
+            std::map< atomic_sentence, bool > ret;
+            for ( uint32_t v = 0; v < atoms.size( ); ++v ) { ret.insert( { atoms[v], v < model.size( ) && model[v] } ); }
+            return ret;
+        }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_ENCODING_HPP
@@ -0,0 +1,162 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_LOCAL_SEARCH_HPP
+#define FIRST_ORDER_LOGIC_SAT_LOCAL_SEARCH_HPP
+#include <list>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "encoding.hpp"
+#include "clause_arena.hpp"
+namespace first_order_logic
+{
+    struct local_search_state
+    {
+        variable_encoding encoding;
+        clause_arena arena;
+        std::vector< clause_ref > clauses;
+        std::vector< std::vector< uint32_t > > occurs;
+        std::vector< bool > assignment;
+        std::vector< uint32_t > true_count, true_xor, break_count, make_count, unsat, unsat_position;
+        std::vector< std::vector< uint32_t > > buckets;
+        std::vector< uint32_t > bucket_position;
+        size_t score_offset = 0, best_bucket = 0;
+        bool empty_clause = false, scored = false;
+        local_search_state( ) { }
+        explicit local_search_state( const std::list< std::list< literal > > & cnf )
+        {
+            for ( const auto & cl : cnf )
+            {
+                std::vector< literal_code > c;
+                for ( const literal & l : cl ) { c.push_back( encoding( l ) ); }
+                add_clause( std::move( c ) );
+            }
+        }
+        size_t num_variables( ) const { return assignment.size( ); }
+        void add_clause( std::vector< literal_code > c )
+        {
+            std::sort( c.begin( ), c.end( ) );
+            c.erase( std::unique( c.begin( ), c.end( ) ), c.end( ) );
+            for ( literal_code l : c )
+            {
+                if ( assignment.size( ) <= literal_variable( l ) )
+                {
+                    assignment.resize( literal_variable( l ) + 1, false );
+                    occurs.resize( assignment.size( ) * 2 );
+                }
+            }
+            for ( size_t i = 1; i < c.size( ); ++i ) { if ( c[i] == negate_literal( c[i - 1] ) ) { return; } }
+            if ( c.empty( ) ) { empty_clause = true; }
+            for ( literal_code l : c ) { occurs[l].push_back( static_cast< uint32_t >( clauses.size( ) ) ); }
+            clauses.push_back( arena.alloc( c.begin( ), c.end( ) ) );
+        }
+        bool value( literal_code l ) const { return assignment[literal_variable( l )] == literal_sign( l ); }
+        size_t bucket( uint32_t v ) const { return static_cast< size_t >( score( v ) + static_cast< int64_t >( score_offset ) ); }
+        void bucket_insert( uint32_t v )
+        {
+            size_t b = bucket( v );
+            bucket_position[v] = static_cast< uint32_t >( buckets[b].size( ) );
+            buckets[b].push_back( v );
+            best_bucket = std::max( best_bucket, b );
+        }
+        void bucket_erase( uint32_t v )
+        {
+            std::vector< uint32_t > & b = buckets[bucket( v )];
+            uint32_t last = b.back( );
+            b[bucket_position[v]] = last;
+            bucket_position[last] = bucket_position[v];
+            b.pop_back( );
+        }
+        void adjust( std::vector< uint32_t > & count, uint32_t v, bool increase )
+        {
+            if ( buckets.empty( ) )
+            {
+                increase ? ++count[v] : --count[v];
+                return;
+            }
+            bucket_erase( v );
+            increase ? ++count[v] : --count[v];
+            bucket_insert( v );
+            while ( buckets[best_bucket].empty( ) ) { --best_bucket; }
+        }
+        uint32_t best_variable( ) const { return buckets[best_bucket].front( ); }
+        void mark_unsat( uint32_t c )
+        {
+            unsat_position[c] = static_cast< uint32_t >( unsat.size( ) );
+            unsat.push_back( c );
+            for ( literal_code l : arena[clauses[c]] ) { adjust( make_count, literal_variable( l ), true ); }
+        }
+        void mark_sat( uint32_t c )
+        {
+            uint32_t last = unsat.back( );
+            unsat[unsat_position[c]] = last;
+            unsat_position[last] = unsat_position[c];
+            unsat.pop_back( );
+            for ( literal_code l : arena[clauses[c]] ) { adjust( make_count, literal_variable( l ), false ); }
+        }
+        void initialise( )
+        {
+            true_count.assign( clauses.size( ), 0 );
+            true_xor.assign( clauses.size( ), 0 );
+            unsat_position.assign( clauses.size( ), 0 );
+            break_count.assign( num_variables( ), 0 );
+            make_count.assign( num_variables( ), 0 );
+            unsat.clear( );
+            buckets.clear( );
+            for ( uint32_t c = 0; c < clauses.size( ); ++c )
+            {
+                for ( literal_code l : arena[clauses[c]] )
+                {
+                    if ( value( l ) )
+                    {
+                        ++true_count[c];
+                        true_xor[c] ^= literal_variable( l );
+                    }
+                }
+                if ( true_count[c] == 0 ) { mark_unsat( c ); }
+                else if ( true_count[c] == 1 ) { ++break_count[true_xor[c]]; }
+            }
+            if ( ! scored || num_variables( ) == 0 ) { return; }
+            score_offset = 0;
+            for ( uint32_t v = 0; v < num_variables( ); ++v )
+            { score_offset = std::max( score_offset, occurs[2 * v].size( ) + occurs[2 * v + 1].size( ) ); }
+            buckets.resize( 2 * score_offset + 1 );
+            bucket_position.assign( num_variables( ), 0 );
+            best_bucket = 0;
+            for ( uint32_t v = 0; v < num_variables( ); ++v ) { bucket_insert( v ); }
+        }
+        template< typename RD >
+        void randomise( RD & rd )
+        {
+            for ( size_t i = 0; i < assignment.size( ); ++i ) { assignment[i] = std::uniform_int_distribution<>( 0, 1 )( rd ); }
+            initialise( );
+        }
+        void flip( uint32_t v )
+        {
+            assignment[v] = ! assignment[v];
+            literal_code now_true = encode_literal( v, assignment[v] );
+            for ( uint32_t c : occurs[now_true] )
+            {
+                true_xor[c] ^= v;
+                if ( ++true_count[c] == 1 )
+                {
+                    mark_sat( c );
+                    adjust( break_count, v, true );
+                }
+                else if ( true_count[c] == 2 ) { adjust( break_count, true_xor[c] ^ v, false ); }
+            }
+            for ( uint32_t c : occurs[negate_literal( now_true )] )
+            {
+                true_xor[c] ^= v;
+                if ( --true_count[c] == 0 )
+                {
+                    mark_unsat( c );
+                    adjust( break_count, v, false );
+                }
+                else if ( true_count[c] == 1 ) { adjust( break_count, true_xor[c], true ); }
+            }
+        }
+        int64_t score( uint32_t v ) const
+        { return static_cast< int64_t >( make_count[v] ) - static_cast< int64_t >( break_count[v] ); }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_LOCAL_SEARCH_HPP
@@ -0,0 +1,147 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_PORTFOLIO_HPP
+#define FIRST_ORDER_LOGIC_SAT_PORTFOLIO_HPP
+#include <list>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <iterator>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "../satisfiability.hpp"
+#include "CDCL.hpp"
+#include "WALKSAT.hpp"
+#include "local_search.hpp"
+namespace first_order_logic
+{
+    struct portfolio_config
+    {
+        std::vector< CDCL_config > CDCL_workers;
+        size_t local_search_workers = 0;
+        focused_walk_config local_search;
+        size_t local_search_flips = 100000000;
+        bool share_clauses = true;
+        size_t share_length = 2;
+        size_t share_capacity = 1024;
+    };
+    portfolio_config default_portfolio( size_t threads = std::thread::hardware_concurrency( ) )
+    {
+        portfolio_config ret;
+        threads = std::max< size_t >( threads, 1 );
+        ret.local_search_workers = threads >= 4 ? 1 : 0;
+        for ( size_t i = 0; ret.CDCL_workers.size( ) + ret.local_search_workers < threads; ++i )
+        {
+            CDCL_config config;
+            config.seed = static_cast< uint32_t >( i );
+            config.restart = i % 2 == 0 ? CDCL_config::restart_policy::glucose : CDCL_config::restart_policy::luby;
+            config.initial_phase = i % 4 == 3;
+            config.variable_decay = i % 3 == 2 ? 0.8 : 0.95;
+            ret.CDCL_workers.push_back( config );
+        }
+        return ret;
+    }
+    struct portfolio_result
+    {
+        satisfiability result = satisfiability::unknown;
+        variable_encoding encoding;
+        std::vector< bool > model;
+    };
+    portfolio_result portfolio_solve( const std::list< std::list< literal > > & cnf, const portfolio_config & config = default_portfolio( ) )
+    {
+        portfolio_result ret;
+        std::vector< std::vector< literal_code > > clauses;
+        clauses.reserve( cnf.size( ) );
+        for ( const auto & cl : cnf )
+        {
+            clauses.emplace_back( );
+            for ( const literal & l : cl ) { clauses.back( ).push_back( ret.encoding( l ) ); }
+        }
+        std::mutex mutex;
+        std::atomic< bool > stop( false );
+        std::vector< std::deque< std::vector< literal_code > > > inbox( config.CDCL_workers.size( ) );
+        auto report =
+            [&]( satisfiability result, const std::vector< bool > & model )
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+                if ( result == satisfiability::unknown || ret.result != satisfiability::unknown ) { return; }
+                ret.result = result;
+                ret.model = model;
+                stop = true;
+            };
+        std::vector< std::thread > workers;
+        for ( size_t i = 0; i < config.CDCL_workers.size( ); ++i )
+        {
+            workers.emplace_back(
+                [&, i]( )
+                {
+                    CDCL_config worker_config = config.CDCL_workers[i];
+                    worker_config.preprocess = false;
+                    CDCL_solver solver( worker_config );
+                    solver.interrupt = & stop;
+                    if ( config.share_clauses )
+                    {
+                        solver.export_clause =
+                            [&, i]( const std::vector< literal_code > & c )
+                            {
+                                if ( c.size( ) > config.share_length ) { return; }
+                                std::lock_guard< std::mutex > lock( mutex );
+                                for ( size_t j = 0; j < inbox.size( ); ++j )
+                                {
+                                    if ( j == i ) { continue; }
+                                    if ( inbox[j].size( ) >= config.share_capacity ) { inbox[j].pop_front( ); }
+                                    inbox[j].push_back( c );
+                                }
+                            };
+                        solver.import_clauses =
+                            [&, i]( std::vector< std::vector< literal_code > > & out )
+                            {
+                                std::lock_guard< std::mutex > lock( mutex );
+                                std::move( inbox[i].begin( ), inbox[i].end( ), std::back_inserter( out ) );
+                                inbox[i].clear( );
+                            };
+                    }
+                    for ( const auto & c : clauses )
+                    {
+                        if ( ! solver.add_clause( c ) )
+                        {
+                            report( satisfiability::unsatisfiable, { } );
+                            return;
+                        }
+                    }
+                    satisfiability result = solver.solve( );
+                    report( result, solver.model );
+                } );
+        }
+        for ( size_t i = 0; i < config.local_search_workers; ++i )
+        {
+            workers.emplace_back(
+                [&, i]( )
+                {
+                    std::mt19937 rd( static_cast< uint32_t >( i + 1 ) );
+                    local_search_state state;
+                    for ( const auto & c : clauses ) { state.add_clause( c ); }
+                    if ( state.empty_clause )
+                    {
+                        report( satisfiability::unsatisfiable, { } );
+                        return;
+                    }
+                    state.randomise( rd );
+                    for ( size_t flips = 0; flips < config.local_search_flips && ! stop; flips += 10000 )
+                    {
+                        if ( focused_random_walk( state, config.local_search, 10000, rd ) == satisfiability::satisfiable )
+                        {
+                            report( satisfiability::satisfiable, state.assignment );
+                            return;
+                        }
+                    }
+                } );
+        }
+        for ( std::thread & t : workers ) { t.join( ); }
+        return ret;
+    }
+    satisfiability portfolio( const std::list< std::list< literal > > & cnf, const portfolio_config & config = default_portfolio( ) )
+    { return portfolio_solve( cnf, config ).result; }
+}
+#endif //FIRST_ORDER_LOGIC_SAT_PORTFOLIO_HPP
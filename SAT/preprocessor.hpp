@@ -0,0 +1,465 @@
+#ifndef FIRST_ORDER_LOGIC_SAT_PREPROCESSOR_HPP
+#define FIRST_ORDER_LOGIC_SAT_PREPROCESSOR_HPP
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "encoding.hpp"
+namespace first_order_logic
+{
+    struct preprocess_config
+    {
+        bool subsumption = true;
+        bool equivalence = true;
+        bool probing = true;
+        bool elimination = true;
+        size_t rounds = 3;
+        size_t occurrence_limit = 16;
+        size_t resolvent_limit = 20;
+        size_t probe_limit = 2000;
+    };
+    struct preprocessor
+    {
+        preprocess_config config;
+        std::vector< std::vector< literal_code > > clauses;
+        std::vector< bool > removed;
+        std::vector< std::vector< size_t > > occurs;
+        std::vector< signed char > assigns;
+        std::vector< bool > frozen, eliminated;
+        std::vector< literal_code > units;
+        std::vector< std::pair< literal_code, std::vector< literal_code > > > reconstruction;
+        std::vector< char > mark;
+        size_t qhead = 0;
+        bool inconsistent = false;
+        preprocessor( ) { }
+        explicit preprocessor( const preprocess_config & config ) : config( config ) { }
+        size_t num_variables( ) const { return assigns.size( ); }
+        void reserve( size_t variables )
+        {
+            if ( variables <= assigns.size( ) ) { return; }
+            assigns.resize( variables, 0 );
+            frozen.resize( variables, false );
+            eliminated.resize( variables, false );
+            occurs.resize( variables * 2 );
+            mark.resize( variables * 2, 0 );
+        }
+        void freeze( uint32_t v )
+        {
+            reserve( v + 1 );
+            frozen[v] = true;
+        }
+        signed char value( literal_code l ) const
+        { return literal_sign( l ) ? assigns[literal_variable( l )] : -assigns[literal_variable( l )]; }
+        void assign( literal_code l )
+        {
+            if ( value( l ) > 0 ) { return; }
+            if ( value( l ) < 0 )
+            {
+                inconsistent = true;
+                return;
+            }
+            assigns[literal_variable( l )] = literal_sign( l ) ? 1 : -1;
+            units.push_back( l );
+        }
+        void add_clause( std::vector< literal_code > c )
+        {
+            for ( literal_code l : c ) { reserve( literal_variable( l ) + 1 ); }
+            if ( inconsistent ) { return; }
+            std::sort( c.begin( ), c.end( ) );
+            c.erase( std::unique( c.begin( ), c.end( ) ), c.end( ) );
+            for ( size_t i = 1; i < c.size( ); ++i ) { if ( c[i] == negate_literal( c[i - 1] ) ) { return; } }
+            if ( std::any_of( c.begin( ), c.end( ), [&]( literal_code l ) { return value( l ) > 0; } ) ) { return; }
+            c.erase(
+                std::remove_if( c.begin( ), c.end( ), [&]( literal_code l ) { return value( l ) < 0; } ),
+                c.end( ) );
+            if ( c.empty( ) )
+            {
+                inconsistent = true;
+                return;
+            }
+            if ( c.size( ) == 1 )
+            {
+                assign( c[0] );
+                return;
+            }
+            for ( literal_code l : c ) { occurs[l].push_back( clauses.size( ) ); }
+            clauses.push_back( std::move( c ) );
+            removed.push_back( false );
+        }
+        bool contains( size_t i, literal_code l ) const
+        { return ! removed[i] && std::binary_search( clauses[i].begin( ), clauses[i].end( ), l ); }
+        void remove_clause( size_t i )
+        {
+            removed[i] = true;
+            std::vector< literal_code >( ).swap( clauses[i] );
+        }
+        void strengthen( size_t i, literal_code l )
+        {
+            std::vector< literal_code > & c = clauses[i];
+            c.erase( std::lower_bound( c.begin( ), c.end( ), l ) );
+            if ( c.size( ) == 1 )
+            {
+                assign( c[0] );
+                remove_clause( i );
+            }
+        }
+        void rebuild_occurs( )
+        {
+            for ( auto & o : occurs ) { o.clear( ); }
+            for ( size_t i = 0; i < clauses.size( ); ++i )
+            { if ( ! removed[i] ) { for ( literal_code l : clauses[i] ) { occurs[l].push_back( i ); } } }
+        }
+        void propagate_units( )
+        {
+            while ( ! inconsistent && qhead < units.size( ) )
+            {
+                literal_code l = units[qhead++];
+                for ( size_t i : occurs[l] ) { if ( contains( i, l ) ) { remove_clause( i ); } }
+                std::vector< size_t > falsified;
+                falsified.swap( occurs[negate_literal( l )] );
+                for ( size_t i : falsified )
+                {
+                    if ( ! contains( i, negate_literal( l ) ) ) { continue; }
+                    if ( std::any_of( clauses[i].begin( ), clauses[i].end( ), [&]( literal_code k ) { return value( k ) > 0; } ) )
+                    {
+                        remove_clause( i );
+                        continue;
+                    }
+                    strengthen( i, negate_literal( l ) );
+                    if ( inconsistent ) { return; }
+                }
+            }
+        }
+        size_t size( ) const
+        {
+            size_t ret = units.size( );
+            for ( size_t i = 0; i < clauses.size( ); ++i ) { if ( ! removed[i] ) { ret += clauses[i].size( ); } }
+            return ret;
+        }
+        void subsume( )
+        {
+            std::vector< size_t > order;
+            for ( size_t i = 0; i < clauses.size( ); ++i ) { if ( ! removed[i] ) { order.push_back( i ); } }
+            std::stable_sort(
+                order.begin( ),
+                order.end( ),
+                [&]( size_t l, size_t r ) { return clauses[l].size( ) < clauses[r].size( ); } );
+            for ( size_t i : order )
+            {
+                if ( removed[i] || inconsistent ) { continue; }
+                const std::vector< literal_code > c = clauses[i];
+                literal_code pivot =
+                    * std::min_element(
+                        c.begin( ),
+                        c.end( ),
+                        [&]( literal_code l, literal_code r )
+                        {
+                            return
+                                occurs[l].size( ) + occurs[negate_literal( l )].size( ) <
+                                occurs[r].size( ) + occurs[negate_literal( r )].size( );
+                        } );
+                for ( literal_code l : c ) { mark[l] = 1; }
+                std::vector< size_t > candidates( occurs[pivot] );
+                candidates.insert( candidates.end( ), occurs[negate_literal( pivot )].begin( ), occurs[negate_literal( pivot )].end( ) );
+                for ( size_t j : candidates )
+                {
+                    if ( j == i || removed[j] || clauses[j].size( ) < c.size( ) ) { continue; }
+                    size_t same = 0, flipped = 0;
+                    literal_code flip = 0;
+                    for ( literal_code l : clauses[j] )
+                    {
+                        if ( mark[l] ) { ++same; }
+                        else if ( mark[negate_literal( l )] )
+                        {
+                            ++flipped;
+                            flip = l;
+                        }
+                    }
+                    if ( same == c.size( ) ) { remove_clause( j ); }
+                    else if ( flipped == 1 && same + 1 == c.size( ) ) { strengthen( j, flip ); }
+                }
+                for ( literal_code l : c ) { mark[l] = 0; }
+                propagate_units( );
+            }
+        }
+        void substitute_equivalences( )
+        {
+            size_t literals = assigns.size( ) * 2;
+            std::vector< std::vector< literal_code > > implies( literals );
+            for ( size_t i = 0; i < clauses.size( ); ++i )
+            {
+                if ( removed[i] || clauses[i].size( ) != 2 ) { continue; }
+                implies[negate_literal( clauses[i][0] )].push_back( clauses[i][1] );
+                implies[negate_literal( clauses[i][1] )].push_back( clauses[i][0] );
+            }
+            const size_t unvisited = std::numeric_limits< size_t >::max( );
+            std::vector< size_t > index( literals, unvisited ), low( literals, 0 );
+            std::vector< bool > on_stack( literals, false );
+            std::vector< literal_code > stack, representative( literals );
+            for ( literal_code l = 0; l < literals; ++l ) { representative[l] = l; }
+            std::vector< std::pair< literal_code, size_t > > calls;
+            size_t counter = 0;
+            bool changed = false;
+            for ( literal_code root = 0; root < literals && ! inconsistent; ++root )
+            {
+                if ( index[root] != unvisited ) { continue; }
+                calls.push_back( { root, 0 } );
+                while ( ! calls.empty( ) )
+                {
+                    literal_code l = calls.back( ).first;
+                    size_t & next = calls.back( ).second;
+                    if ( next == 0 && index[l] == unvisited )
+                    {
+                        index[l] = low[l] = counter++;
+                        stack.push_back( l );
+                        on_stack[l] = true;
+                    }
+                    if ( next < implies[l].size( ) )
+                    {
+                        literal_code k = implies[l][next++];
+                        if ( index[k] == unvisited ) { calls.push_back( { k, 0 } ); }
+                        else if ( on_stack[k] ) { low[l] = std::min( low[l], index[k] ); }
+                        continue;
+                    }
+                    calls.pop_back( );
+                    if ( ! calls.empty( ) ) { low[calls.back( ).first] = std::min( low[calls.back( ).first], low[l] ); }
+                    if ( low[l] != index[l] ) { continue; }
+                    std::vector< literal_code > component;
+                    do
+                    {
+                        component.push_back( stack.back( ) );
+                        on_stack[stack.back( )] = false;
+                        stack.pop_back( );
+                    }
+                    while ( component.back( ) != l );
+                    if ( component.size( ) == 1 ) { continue; }
+                    literal_code rep =
+                        * std::min_element(
+                            component.begin( ),
+                            component.end( ),
+                            [&]( literal_code a, literal_code b )
+                            {
+                                return
+                                    std::make_pair( ! frozen[literal_variable( a )], literal_variable( a ) ) <
+                                    std::make_pair( ! frozen[literal_variable( b )], literal_variable( b ) );
+                            } );
+                    for ( literal_code k : component )
+                    {
+                        if ( literal_variable( k ) == literal_variable( rep ) && k != rep ) { inconsistent = true; }
+                        if ( literal_variable( k ) == literal_variable( rep ) || frozen[literal_variable( k )] ) { continue; }
+                        representative[k] = rep;
+                        representative[negate_literal( k )] = negate_literal( rep );
+                        changed = true;
+                    }
+                }
+            }
+            if ( inconsistent || ! changed ) { return; }
+            for ( uint32_t v = 0; v < assigns.size( ); ++v )
+            {
+                literal_code x = encode_literal( v, true ), r = representative[x];
+                if ( r == x ) { continue; }
+                eliminated[v] = true;
+                reconstruction.push_back( { x, { x, negate_literal( r ) } } );
+                reconstruction.push_back( { negate_literal( x ), { negate_literal( x ), r } } );
+            }
+            std::vector< std::vector< literal_code > > old;
+            old.swap( clauses );
+            std::vector< bool > old_removed;
+            old_removed.swap( removed );
+            for ( auto & o : occurs ) { o.clear( ); }
+            for ( size_t i = 0; i < old.size( ); ++i )
+            {
+                if ( old_removed[i] ) { continue; }
+                for ( literal_code & l : old[i] ) { l = representative[l]; }
+                add_clause( std::move( old[i] ) );
+            }
+        }
+        bool probe_conflict( literal_code probe, std::vector< signed char > & local )
+        {
+            auto val = [&]( literal_code l )
+            {
+                signed char v = assigns[literal_variable( l )] != 0 ? assigns[literal_variable( l )] : local[literal_variable( l )];
+                return literal_sign( l ) ? v : -v;
+            };
+            std::vector< literal_code > trail { probe };
+            local[literal_variable( probe )] = literal_sign( probe ) ? 1 : -1;
+            bool conflict = false;
+            for ( size_t head = 0; head < trail.size( ) && ! conflict; ++head )
+            {
+                for ( size_t i : occurs[negate_literal( trail[head] )] )
+                {
+                    if ( ! contains( i, negate_literal( trail[head] ) ) ) { continue; }
+                    size_t open = 0;
+                    literal_code last = 0;
+                    bool satisfied = false;
+                    for ( literal_code l : clauses[i] )
+                    {
+                        if ( val( l ) > 0 )
+                        {
+                            satisfied = true;
+                            break;
+                        }
+                        if ( val( l ) == 0 )
+                        {
+                            ++open;
+                            last = l;
+                        }
+                    }
+                    if ( satisfied ) { continue; }
+                    if ( open == 0 )
+                    {
+                        conflict = true;
+                        break;
+                    }
+                    if ( open == 1 )
+                    {
+                        local[literal_variable( last )] = literal_sign( last ) ? 1 : -1;
+                        trail.push_back( last );
+                    }
+                }
+            }
+            for ( literal_code l : trail ) { local[literal_variable( l )] = 0; }
+            return conflict;
+        }
+        void probe( )
+        {
+            std::vector< signed char > local( assigns.size( ), 0 );
+            size_t budget = config.probe_limit;
+            for ( uint32_t v = 0; v < assigns.size( ) && budget > 0 && ! inconsistent; ++v )
+            {
+                if ( eliminated[v] ) { continue; }
+                for ( bool b : { true, false } )
+                {
+                    literal_code l = encode_literal( v, b );
+                    if ( assigns[v] != 0 || occurs[negate_literal( l )].empty( ) || budget == 0 ) { continue; }
+                    --budget;
+                    if ( probe_conflict( l, local ) )
+                    {
+                        assign( negate_literal( l ) );
+                        propagate_units( );
+                    }
+                }
+            }
+        }
+        std::vector< size_t > live_occurs( literal_code l )
+        {
+            std::vector< size_t > ret;
+            for ( size_t i : occurs[l] ) { if ( contains( i, l ) ) { ret.push_back( i ); } }
+            std::sort( ret.begin( ), ret.end( ) );
+            ret.erase( std::unique( ret.begin( ), ret.end( ) ), ret.end( ) );
+            return ret;
+        }
+        bool resolve( const std::vector< literal_code > & p, const std::vector< literal_code > & n, uint32_t v, std::vector< literal_code > & out )
+        {
+            out.clear( );
+            for ( literal_code l : p ) { if ( literal_variable( l ) != v ) { out.push_back( l ); } }
+            for ( literal_code l : n )
+            {
+                if ( literal_variable( l ) == v ) { continue; }
+                if ( std::find( out.begin( ), out.end( ), negate_literal( l ) ) != out.end( ) ) { return false; }
+                if ( std::find( out.begin( ), out.end( ), l ) == out.end( ) ) { out.push_back( l ); }
+            }
+            return true;
+        }
+        void eliminate( )
+        {
+            rebuild_occurs( );
+            std::vector< uint32_t > order;
+            for ( uint32_t v = 0; v < assigns.size( ); ++v )
+            { if ( ! frozen[v] && ! eliminated[v] && assigns[v] == 0 ) { order.push_back( v ); } }
+            std::stable_sort(
+                order.begin( ),
+                order.end( ),
+                [&]( uint32_t l, uint32_t r )
+                {
+                    return
+                        occurs[encode_literal( l, true )].size( ) + occurs[encode_literal( l, false )].size( ) <
+                        occurs[encode_literal( r, true )].size( ) + occurs[encode_literal( r, false )].size( );
+                } );
+            std::vector< literal_code > resolvent;
+            for ( uint32_t v : order )
+            {
+                if ( inconsistent ) { return; }
+                if ( assigns[v] != 0 ) { continue; }
+                std::vector< size_t > pos = live_occurs( encode_literal( v, true ) ), neg = live_occurs( encode_literal( v, false ) );
+                if ( pos.empty( ) && neg.empty( ) ) { continue; }
+                if ( pos.size( ) > config.occurrence_limit || neg.size( ) > config.occurrence_limit ) { continue; }
+                std::vector< std::vector< literal_code > > resolvents;
+                bool bounded = true;
+                for ( size_t p : pos )
+                {
+                    for ( size_t n : neg )
+                    {
+                        if ( ! resolve( clauses[p], clauses[n], v, resolvent ) ) { continue; }
+                        if ( resolvent.size( ) > config.resolvent_limit || resolvents.size( ) >= pos.size( ) + neg.size( ) )
+                        {
+                            bounded = false;
+                            break;
+                        }
+                        resolvents.push_back( resolvent );
+                    }
+                    if ( ! bounded ) { break; }
+                }
+                if ( ! bounded ) { continue; }
+                eliminated[v] = true;
+                for ( size_t p : pos )
+                {
+                    reconstruction.push_back( { encode_literal( v, true ), clauses[p] } );
+                    remove_clause( p );
+                }
+                for ( size_t n : neg )
+                {
+                    reconstruction.push_back( { encode_literal( v, false ), clauses[n] } );
+                    remove_clause( n );
+                }
+                for ( auto & r : resolvents ) { add_clause( std::move( r ) ); }
+                propagate_units( );
+            }
+        }
+        bool run( )
+        {
+            rebuild_occurs( );
+            propagate_units( );
+            for ( size_t round = 0; round < config.rounds && ! inconsistent; ++round )
+            {
+                size_t before = size( );
+                if ( config.subsumption ) { subsume( ); }
+                if ( config.equivalence && ! inconsistent )
+                {
+                    substitute_equivalences( );
+                    propagate_units( );
+                }
+                if ( config.probing && ! inconsistent ) { probe( ); }
+                if ( config.elimination && ! inconsistent ) { eliminate( ); }
+                if ( size( ) == before ) { break; }
+            }
+            return ! inconsistent;
+        }
+        template< typename OUTITER >
+        OUTITER simplified( OUTITER out ) const
+        {
+            for ( size_t i = 0; i < clauses.size( ); ++i )
+            {
+                if ( removed[i] ) { continue; }
+                * out = clauses[i];
+                ++out;
+            }
+            return out;
+        }
+        void extend( std::vector< bool > & model ) const
+        {
+            if ( model.size( ) < assigns.size( ) ) { model.resize( assigns.size( ), false ); }
+            for ( uint32_t v = 0; v < assigns.size( ); ++v ) { if ( assigns[v] != 0 ) { model[v] = assigns[v] > 0; } }
+            for ( auto it = reconstruction.rbegin( ); it != reconstruction.rend( ); ++it )
+            {
+                if ( std::none_of(
+                        it->second.begin( ),
+                        it->second.end( ),
+                        [&]( literal_code l ) { return model[literal_variable( l )] == literal_sign( l ); } ) )
+                { model[literal_variable( it->first )] = literal_sign( it->first ); }
+            }
+        }
+    };
+}
+#endif //FIRST_ORDER_LOGIC_SAT_PREPROCESSOR_HPP
@@ -0,0 +1,29 @@
+#include <fstream>
+#include <iostream>
+#include "first_order_logic.hpp"
+#include "SAT/DRAT_checker.hpp"
+int main( int argc, char ** argv )
+{
+    if ( argc != 3 )
+    {
+        std::cerr << "usage: " << argv[0] << " <formula.cnf> <proof.drat>" << std::endl;
+        return 1;
+    }
+    std::ifstream cnf( argv[1], std::ios::binary ), proof( argv[2], std::ios::binary );
+    if ( ! cnf || ! proof )
+    {
+        std::cerr << "drat_check: cannot open input" << std::endl;
+        return 1;
+    }
+    try
+    {
+        bool verified = first_order_logic::check_DRAT( cnf, proof );
+        std::cout << ( verified ? "s VERIFIED" : "s NOT VERIFIED" ) << std::endl;
+        return verified ? 0 : 1;
+    }
+    catch ( const std::exception & e )
+    {
+        std::cerr << "drat_check: " << e.what( ) << std::endl;
+        return 1;
+    }
+}
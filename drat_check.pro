@@ -0,0 +1,16 @@
+TEMPLATE = app
+TARGET = drat_check
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+QMAKE_CXXFLAGS += -std=c++1y -stdlib=libc++
+QMAKE_LFLAGS += -stdlib=libc++
+SOURCES += drat_check.cpp
+HEADERS += \
+    first_order_logic.hpp \
+    SAT/encoding.hpp \
+    SAT/clause_arena.hpp \
+    SAT/DIMACS.hpp \
+    SAT/DRAT_checker.hpp
+
+INCLUDEPATH += ../hana/include/
@@ -1,5 +1,8 @@
 #ifndef FIRST_ORDER_LOGIC_FIRST_ORDER_LOGIC_HPP
 #define FIRST_ORDER_LOGIC_FIRST_ORDER_LOGIC_HPP
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "sentence/sentence.hpp"
 #include "sentence/atomic_sentence.hpp"
 #include "sentence/term.hpp"
@@ -67,6 +70,31 @@ namespace first_order_logic
         return ret_type( sentence_type::logical_not, { static_cast< ret_type >( s ) } );
     }
 
+    template< typename T >
+    T make_junction( sentence_type type, const std::vector< T > & arguments )
+    {
+        if ( arguments.empty( ) ) { throw std::invalid_argument( "empty junction" ); }
+        if ( arguments.size( ) == 1 ) { return arguments.front( ); }
+        std::vector< T > flattened;
+        flattened.reserve( arguments.size( ) );
+        for ( const T & s : arguments )
+        {
+            if ( s->type != type )
+            {
+                flattened.push_back( s );
+                continue;
+            }
+            for ( const auto & arg : s->arguments ) { flattened.push_back( boost::get< T >( arg ) ); }
+        }
+        return T( type, flattened );
+    }
+
+    template< typename T >
+    T make_and( const std::vector< T > & arguments ) { return make_junction( sentence_type::logical_and, arguments ); }
+
+    template< typename T >
+    T make_or( const std::vector< T > & arguments ) { return make_junction( sentence_type::logical_or, arguments ); }
+
     template< typename T1, typename T2 >
     typename add_sentence_front
     <
@@ -81,12 +109,7 @@ namespace first_order_logic
             typename std::common_type< T1, T2 >::type,
             set_c< sentence_type, sentence_type::logical_and >
         >::type ret_type;
-        return
-            ret_type( sentence_type::logical_and,
-                    {
-                        static_cast< ret_type >( l ),
-                        static_cast< ret_type >( r )
-                    } );
+        return make_and( std::vector< ret_type > { static_cast< ret_type >( l ), static_cast< ret_type >( r ) } );
     }
 
     template< typename T1, typename T2 >
@@ -103,12 +126,7 @@ namespace first_order_logic
             typename std::common_type< T1, T2 >::type,
             set_c< sentence_type, sentence_type::logical_or >
         >::type ret_type;
-        return
-                ret_type( sentence_type::logical_or,
-                {
-                    static_cast< ret_type >( l ),
-                    static_cast< ret_type >( r )
-                } );
+        return make_or( std::vector< ret_type > { static_cast< ret_type >( l ), static_cast< ret_type >( r ) } );
     }
 
     template< typename T >
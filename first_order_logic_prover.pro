@@ -5,7 +5,7 @@ CONFIG -= qt
 QMAKE_CXXFLAGS += -std=c++1y -stdlib=libc++
 QMAKE_LFLAGS += -stdlib=libc++
 SOURCES += main.cpp
-LIBS += -lboost_unit_test_framework
+LIBS += -lboost_unit_test_framework -lpthread
 HEADERS += \
     test.hpp \
     forward/first_order_logic.hpp \
@@ -31,8 +31,27 @@ HEADERS += \
     FOL/resolution.hpp \
     SAT/DPLL.hpp \
     SAT/WALKSAT.hpp \
+    SAT/CDCL.hpp \
+    SAT/encoding.hpp \
+    SAT/clause_arena.hpp \
+    SAT/activity_heap.hpp \
+    SAT/DIMACS.hpp \
+    SAT/preprocessor.hpp \
+    SAT/local_search.hpp \
+    SAT/portfolio.hpp \
+    SAT/cube_and_conquer.hpp \
+    SAT/DRAT.hpp \
+    SAT/buffered_writer.hpp \
+    SAT/clause_sink.hpp \
+    SAT/DRAT_checker.hpp \
+    SAT/bit_parallel.hpp \
     sentence/CNF.hpp \
-    FOL/term_generator.hpp
+    sentence/simplify.hpp \
+    FOL/term_generator.hpp \
+    FOL/demodulation.hpp \
+    FOL/resolution_proof.hpp \
+    FOL/resolution_session.hpp \
+    FOL/instance_generation.hpp
 OTHER_FILES += \
     theorem_prover.pro.user \
     LICENSE \
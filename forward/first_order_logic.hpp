@@ -37,6 +37,12 @@ namespace first_order_logic
     >::type
     make_or( const T1 & l, const T2 & r );
 
+    template< typename T >
+    T make_and( const std::vector< T > & arguments );
+
+    template< typename T >
+    T make_or( const std::vector< T > & arguments );
+
     template< typename T1, typename T2 >
     auto make_imply( const T1 & l, const T2 & r ) { return make_or( make_not( l ), r ); }
 
@@ -2,7 +2,12 @@
 #define FIRST_ORDER_LOGIC_SENTENCE_CNF_HPP
 #include "../sentence/sentence.hpp"
 #include <list>
+#include <map>
 #include <set>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <iterator>
 #include <algorithm>
 #include <boost/iterator/transform_iterator.hpp>
@@ -45,42 +50,126 @@ namespace first_order_logic
             set_c< sentence_type, sentence_type::logical_not >
         >
     > negation_in_type;
+    typedef sentence< vector < set_c< sentence_type, sentence_type::logical_not > > > not_type;
+    struct hash_cons
+    {
+        size_t size = 0;
+        std::map< atomic_sentence, size_t > atoms;
+        std::map< std::pair< sentence_type, std::vector< size_t > >, size_t > nodes;
+        std::unordered_map< const void *, size_t > id;
+        std::vector< size_t > occurrences;
+        bool shared( const free_propositional_sentence & s ) const { return occurrences[id.at( s.data.get( ) )] > 1; }
+        size_t operator ( )( const free_propositional_sentence & prop )
+        {
+            std::vector< std::pair< const free_propositional_sentence *, bool > > pending( 1, { & prop, false } );
+            while ( ! pending.empty( ) )
+            {
+                const free_propositional_sentence & s = * pending.back( ).first;
+                if ( id.count( s.data.get( ) ) != 0 )
+                {
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( s->type == sentence_type::pass )
+                {
+                    auto it = atoms.insert( { boost::get< atomic_sentence >( s->arguments[0] ), size } );
+                    if ( it.second )
+                    {
+                        ++size;
+                        occurrences.push_back( 0 );
+                    }
+                    id.insert( { s.data.get( ), it.first->second } );
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( ! pending.back( ).second )
+                {
+                    pending.back( ).second = true;
+                    for ( const auto & arg : s->arguments )
+                    { pending.push_back( { & boost::get< free_propositional_sentence >( arg ), false } ); }
+                    continue;
+                }
+                pending.pop_back( );
+                std::vector< size_t > arguments;
+                arguments.reserve( s->arguments.size( ) );
+                for ( const auto & arg : s->arguments )
+                {
+                    arguments.push_back( id.at( boost::get< free_propositional_sentence >( arg ).data.get( ) ) );
+                    ++occurrences[arguments.back( )];
+                }
+                auto it = nodes.insert( { { s->type, arguments }, size } );
+                if ( it.second )
+                {
+                    ++size;
+                    occurrences.push_back( 0 );
+                }
+                id.insert( { s.data.get( ), it.first->second } );
+            }
+            return id.at( prop.data.get( ) );
+        }
+    };
     negation_in_type move_negation_in( const free_propositional_sentence & prop )
     {
-        return prop.type_restore_full< negation_in_type >
-                (
-                    make_not_actor(
-                        [&]( const free_propositional_sentence & sen )
-                        {
-                            return sen.type_restore_full< negation_in_type >(
-                                    make_not_actor(
-                                            [&]( const free_propositional_sentence & sen )
-                                            { return move_negation_in( sen ); } ),
-                                    make_and_actor(
-                                            [&]( const free_propositional_sentence & l,
-                                                 const free_propositional_sentence & r )
-                                            {
-                                                return make_or(
-                                                    move_negation_in( make_not( l ) ),
-                                                    move_negation_in( make_not( r ) ) );
-                                            } ),
-                                    make_or_actor(
-                                        [&]( const free_propositional_sentence & l,
-                                             const free_propositional_sentence & r )
-                                        {
-                                            return make_and(
-                                                move_negation_in( make_not( l ) ),
-                                                move_negation_in( make_not( r ) ) );
-                                        } ),
-                                    make_atomic_actor( []( const atomic_sentence & as ) { return make_not( as ); } ) );
-                        } ),
-                    make_and_actor(
-                        [&]( const free_propositional_sentence & l, const free_propositional_sentence & r )
-                            { return make_and( move_negation_in( l ), move_negation_in( r ) ); } ),
-                    make_or_actor(
-                        [&]( const free_propositional_sentence & l, const free_propositional_sentence & r )
-                            { return make_or( move_negation_in( l ), move_negation_in( r ) ); } ),
-                    make_atomic_actor( []( const atomic_sentence & as ) { return as; } ) );
+        hash_cons ids;
+        ids( prop );
+        std::map< std::pair< size_t, bool >, negation_in_type > memo;
+        struct frame
+        {
+            const free_propositional_sentence * node;
+            bool positive;
+            size_t next, base;
+        };
+        std::vector< frame > stack( 1, frame { & prop, true, 0, 0 } );
+        std::vector< negation_in_type > results;
+        while ( ! stack.empty( ) )
+        {
+            frame & f = stack.back( );
+            const free_propositional_sentence & s = * f.node;
+            if ( s->type == sentence_type::logical_not )
+            {
+                f = frame { & boost::get< free_propositional_sentence >( s->arguments[0] ), ! f.positive, 0, 0 };
+                continue;
+            }
+            std::pair< size_t, bool > key( ids.id.at( s.data.get( ) ), f.positive );
+            if ( f.next == 0 )
+            {
+                auto it = memo.find( key );
+                if ( it != memo.end( ) )
+                {
+                    results.push_back( it->second );
+                    stack.pop_back( );
+                    continue;
+                }
+                f.base = results.size( );
+            }
+            if ( s->type == sentence_type::pass )
+            {
+                not_type as( boost::get< atomic_sentence >( s->arguments[0] ) );
+                results.push_back(
+                    negation_in_type(
+                        sentence_type::pass,
+                        f.positive ? as : not_type( sentence_type::logical_not, { as } ) ) );
+                memo.insert( { key, results.back( ) } );
+                stack.pop_back( );
+                continue;
+            }
+            if ( f.next < s->arguments.size( ) )
+            {
+                frame child { & boost::get< free_propositional_sentence >( s->arguments[f.next++] ), f.positive, 0, 0 };
+                stack.push_back( child );
+                continue;
+            }
+            negation_in_type ret(
+                ( s->type == sentence_type::logical_and ) == f.positive ?
+                    sentence_type::logical_and :
+                    sentence_type::logical_or,
+                std::vector< negation_in_type >( results.begin( ) + f.base, results.end( ) ) );
+            results.erase( results.begin( ) + f.base, results.end( ) );
+            results.push_back( ret );
+            memo.insert( { key, ret } );
+            stack.pop_back( );
+        }
+        return results.back( );
     }
     typedef
     sentence
@@ -112,59 +201,94 @@ namespace first_order_logic
             set_c< sentence_type, sentence_type::logical_not >
         >
     > or_not_type;
-    typedef sentence< vector < set_c< sentence_type, sentence_type::logical_not > > > not_type;
     static_assert( std::is_convertible< or_and_or_not_type, negation_in_type >::value, "should be convertible" );
     static_assert( std::is_convertible< not_type, free_propositional_sentence >::value, "should be convertible" );
     static_assert( std::is_convertible< or_not_type, and_or_not_type >::value, "should be convertible" );
     static_assert( std::is_same< and_or_not_type::not_sentence_type, not_type >::value, "should be same" );
     and_or_not_type move_or_in( const negation_in_type & prop )
     {
-        return prop.type_restore_full< and_or_not_type >(
-                make_not_actor( []( const not_type & sen )->and_or_not_type { return make_not( sen ); } ),
-                make_and_actor(
-                    []( const negation_in_type & l, const negation_in_type & r )
-                        { return make_and( move_or_in( l ), move_or_in( r ) ); } ),
-                make_or_actor(
-                    []( const negation_in_type & l, const negation_in_type & r )
-                        {
-                            auto switch_process =
-                                [&]( const or_not_type & as )->and_or_not_type
-                                {
-                                    return move_or_in( r ).type_restore_full< and_or_not_type >(
-                                        make_and_actor(
-                                            [&]( const and_or_not_type & ll, const and_or_not_type & rr )
-                                            {
-                                                return make_and(
-                                                    move_or_in( make_or( as, ll ) ),
-                                                    move_or_in( make_or( as, rr ) ) );
-                                            } ),
-                                        make_or_actor(
-                                            [&]( const or_not_type & ll, const or_not_type & rr )
-                                            { return make_or( as, make_or( ll, rr ) ); } ),
-                                        make_not_actor(
-                                            [&]( const not_type & s )
-                                            { return make_or( as, make_not( s ) ); } ),
-                                        make_atomic_actor(
-                                            [&]( const atomic_sentence & s )
-                                            { return make_or( as, s ); } ) );
-                                };
-                            return move_or_in( l ).template type_restore_full< and_or_not_type >(
-                                make_and_actor(
-                                    [&]( const and_or_not_type & ll, const and_or_not_type & rr )
-                                    {
-                                        return make_and(
-                                            move_or_in( make_or( r, ll ) ),
-                                            move_or_in( make_or( r, rr ) ) );
-                                    } ),
-                                make_or_actor(
-                                    [&]( const or_not_type & ll, const or_not_type & rr )
-                                    { return switch_process( make_or( ll, rr ) ); } ),
-                                make_not_actor(
-                                    [&]( const not_type & s ) { return switch_process( make_not( s ) ); } ),
-                                make_atomic_actor(
-                                    [&]( const atomic_sentence & as ) { return switch_process( as ); } ) );
-                        } ),
-                make_atomic_actor( []( const atomic_sentence & as ) { return as; } ) );
+        typedef std::vector< std::vector< not_type > > clause_set;
+        struct frame
+        {
+            const negation_in_type * node;
+            size_t next, base;
+        };
+        std::unordered_map< const void *, clause_set > memo;
+        std::vector< frame > stack( 1, frame { & prop, 0, 0 } );
+        std::vector< clause_set > results;
+        while ( ! stack.empty( ) )
+        {
+            frame & f = stack.back( );
+            const negation_in_type & s = * f.node;
+            if ( f.next == 0 )
+            {
+                auto it = memo.find( s.data.get( ) );
+                if ( it != memo.end( ) )
+                {
+                    results.push_back( it->second );
+                    stack.pop_back( );
+                    continue;
+                }
+            }
+            if ( s->type == sentence_type::pass )
+            {
+                results.emplace_back( 1, std::vector< not_type >( 1, boost::get< not_type >( s->arguments[0] ) ) );
+                stack.pop_back( );
+                continue;
+            }
+            if ( f.next == 0 ) { f.base = results.size( ); }
+            if ( f.next < s->arguments.size( ) )
+            {
+                frame child { & boost::get< negation_in_type >( s->arguments[f.next++] ), 0, 0 };
+                stack.push_back( child );
+                continue;
+            }
+            clause_set combined = std::move( results[f.base] );
+            for ( size_t i = f.base + 1; i < results.size( ); ++i )
+            {
+                clause_set & r = results[i];
+                if ( s->type == sentence_type::logical_and )
+                {
+                    std::move( r.begin( ), r.end( ), std::back_inserter( combined ) );
+                    continue;
+                }
+                clause_set product;
+                product.reserve( combined.size( ) * r.size( ) );
+                for ( const auto & lc : combined )
+                {
+                    for ( const auto & rc : r )
+                    {
+                        product.push_back( lc );
+                        product.back( ).insert( product.back( ).end( ), rc.begin( ), rc.end( ) );
+                    }
+                }
+                combined = std::move( product );
+            }
+            results.resize( f.base );
+            results.push_back( std::move( combined ) );
+            if ( s.data.use_count( ) > 1 ) { memo.insert( { s.data.get( ), results.back( ) } ); }
+            stack.pop_back( );
+        }
+        std::vector< and_or_not_type > conjuncts;
+        conjuncts.reserve( results.back( ).size( ) );
+        std::set< std::vector< const void * > > emitted;
+        for ( const auto & c : results.back( ) )
+        {
+            std::vector< const void * > key;
+            key.reserve( c.size( ) );
+            for ( const not_type & l : c ) { key.push_back( l.data.get( ) ); }
+            std::sort( key.begin( ), key.end( ) );
+            key.erase( std::unique( key.begin( ), key.end( ) ), key.end( ) );
+            if ( ! emitted.insert( key ).second ) { continue; }
+            std::vector< or_not_type > disjuncts;
+            disjuncts.reserve( c.size( ) );
+            for ( const not_type & l : c ) { disjuncts.push_back( or_not_type( sentence_type::pass, l ) ); }
+            conjuncts.push_back(
+                and_or_not_type(
+                    sentence_type::pass,
+                    disjuncts.size( ) == 1 ? disjuncts.front( ) : or_not_type( sentence_type::logical_or, disjuncts ) ) );
+        }
+        return conjuncts.size( ) == 1 ? conjuncts.front( ) : and_or_not_type( sentence_type::logical_and, conjuncts );
     }
 
     struct literal
@@ -182,65 +306,53 @@ namespace first_order_logic
 
     literal get_literal( const not_type & nt )
     {
-        return nt.type_restore_full< literal >(
-                make_not_actor(
-                    []( const not_type & n )
-                    {
-                        literal ret = get_literal( n );
-                        ret.b = ! ret.b;
-                        return ret;
-                    } ),
-                make_atomic_actor( []( const atomic_sentence & as ) { return literal( as, true ); } ) );
+        bool b = true;
+        const not_type * s = & nt;
+        while ( (*s)->type == sentence_type::logical_not )
+        {
+            b = ! b;
+            s = & boost::get< not_type >( (*s)->arguments[0] );
+        }
+        return literal( boost::get< atomic_sentence >( (*s)->arguments[0] ), b );
     }
 
     template< typename OUTITER >
     OUTITER get_clause( const or_not_type & prop, OUTITER result )
     {
-        return
-            prop.type_restore_full< OUTITER >
-            (
-                make_or_actor(
-                    [&]( const or_not_type & l, const or_not_type & r )
-                        { return get_clause( l, get_clause( r, result ) ); } ),
-                make_not_actor(
-                    [&]( const not_type & sen )
-                    {
-                        literal l = get_literal( sen );
-                        l.b = ! l.b;
-                        * result = l;
-                        ++result;
-                        return result;
-                    } ),
-                make_atomic_actor(
-                    [&]( const atomic_sentence & as )
-                    {
-                        * result = literal( as, true );
-                        ++result;
-                        return result;
-                    } )
-            );
+        std::vector< const or_not_type * > pending( 1, & prop );
+        while ( ! pending.empty( ) )
+        {
+            const or_not_type & s = * pending.back( );
+            pending.pop_back( );
+            if ( s->type == sentence_type::pass )
+            {
+                * result = get_literal( boost::get< not_type >( s->arguments[0] ) );
+                ++result;
+                continue;
+            }
+            for ( const auto & arg : s->arguments ) { pending.push_back( & boost::get< or_not_type >( arg ) ); }
+        }
+        return result;
     }
 
     template< typename OUTITER >
     OUTITER get_cnf( const and_or_not_type & prop, OUTITER result )
     {
-        auto extract_clause =
-            [&]( const or_not_type & t )
+        std::vector< const and_or_not_type * > pending( 1, & prop );
+        while ( ! pending.empty( ) )
+        {
+            const and_or_not_type & s = * pending.back( );
+            pending.pop_back( );
+            if ( s->type == sentence_type::pass )
             {
-                result = get_clause( t, result );
+                result = get_clause( boost::get< or_not_type >( s->arguments[0] ), result );
                 * result = std::experimental::optional< literal >( );
                 ++result;
-                return result;
-            };
-        return prop.type_restore_full< OUTITER >(
-                make_and_actor(
-                    [&]( const and_or_not_type & l, const and_or_not_type & r )
-                    { return get_cnf( l, get_cnf( r, result ) ); } ),
-                make_not_actor( [&]( const not_type & l ) { return extract_clause( make_not( l ) ); } ),
-                make_or_actor(
-                    [&]( const or_not_type & l, const or_not_type & r )
-                    { return extract_clause( make_or( l, r ) ); } ),
-                make_atomic_actor( [&]( const atomic_sentence & as ) { return extract_clause( as ); } ) );
+                continue;
+            }
+            for ( const auto & arg : s->arguments ) { pending.push_back( & boost::get< and_or_not_type >( arg ) ); }
+        }
+        return result;
     }
 
     and_or_not_type pre_CNF( const free_propositional_sentence & prop )
@@ -250,12 +362,138 @@ namespace first_order_logic
     OUTITER to_CNF( const free_propositional_sentence & prop, OUTITER out )
     { return get_cnf( pre_CNF( prop ), out ); }
 
-    std::list< std::list< literal > > list_list_literal( const free_propositional_sentence & sen )
+    struct definitional_CNF_config
+    {
+        size_t threshold = 8;
+        std::string prefix = "_d";
+        mutable size_t fresh = 0;
+        mutable std::unordered_set< std::string > used;
+    };
+
+    template< typename OUTITER >
+    OUTITER definitional_CNF(
+        const free_propositional_sentence & prop,
+        OUTITER result,
+        const definitional_CNF_config & config = definitional_CNF_config( ) )
+    {
+        typedef std::vector< std::vector< literal > > clause_set;
+        hash_cons ids;
+        ids( prop );
+        for ( const auto & a : ids.atoms ) { config.used.insert( a.first.name ); }
+        std::map< std::pair< size_t, bool >, clause_set > memo;
+        auto emit =
+            [&]( const std::vector< literal > & c )
+            {
+                for ( const literal & l : c )
+                {
+                    * result = std::experimental::optional< literal >( l );
+                    ++result;
+                }
+                * result = std::experimental::optional< literal >( );
+                ++result;
+            };
+        auto name =
+            [&]( clause_set & cs )
+            {
+                if ( cs.size( ) <= 1 ) { return; }
+                std::string n;
+                do { n = config.prefix + std::to_string( config.fresh++ ); } while ( ! config.used.insert( n ).second );
+                atomic_sentence x( n, { } );
+                for ( auto & c : cs )
+                {
+                    c.insert( c.begin( ), literal( x, false ) );
+                    emit( c );
+                }
+                cs.assign( 1, std::vector< literal >( 1, literal( x, true ) ) );
+            };
+        struct frame
+        {
+            const free_propositional_sentence * node;
+            bool positive;
+            size_t next, base;
+        };
+        std::vector< frame > stack( 1, frame { & prop, true, 0, 0 } );
+        std::vector< clause_set > results;
+        while ( ! stack.empty( ) )
+        {
+            frame & f = stack.back( );
+            const free_propositional_sentence & s = * f.node;
+            if ( s->type == sentence_type::pass )
+            {
+                results.emplace_back( 1, std::vector< literal >( 1, literal( boost::get< atomic_sentence >( s->arguments[0] ), f.positive ) ) );
+                stack.pop_back( );
+                continue;
+            }
+            if ( s->type == sentence_type::logical_not )
+            {
+                f = frame { & boost::get< free_propositional_sentence >( s->arguments[0] ), ! f.positive, 0, 0 };
+                continue;
+            }
+            std::pair< size_t, bool > key( ids.id.at( s.data.get( ) ), f.positive );
+            if ( f.next == 0 )
+            {
+                auto it = memo.find( key );
+                if ( it != memo.end( ) )
+                {
+                    name( it->second );
+                    results.push_back( it->second );
+                    stack.pop_back( );
+                    continue;
+                }
+                f.base = results.size( );
+            }
+            if ( f.next < s->arguments.size( ) )
+            {
+                frame child { & boost::get< free_propositional_sentence >( s->arguments[f.next++] ), f.positive, 0, 0 };
+                stack.push_back( child );
+                continue;
+            }
+            bool conjunction = ( s->type == sentence_type::logical_and ) == f.positive;
+            clause_set combined = std::move( results[f.base] );
+            for ( size_t i = f.base + 1; i < results.size( ); ++i )
+            {
+                clause_set & r = results[i];
+                if ( conjunction )
+                {
+                    std::move( r.begin( ), r.end( ), std::back_inserter( combined ) );
+                    continue;
+                }
+                if ( combined.size( ) * r.size( ) > config.threshold )
+                {
+                    name( combined.size( ) >= r.size( ) ? combined : r );
+                    if ( combined.size( ) * r.size( ) > config.threshold )
+                    {
+                        name( combined );
+                        name( r );
+                    }
+                }
+                clause_set product;
+                product.reserve( combined.size( ) * r.size( ) );
+                for ( const auto & lc : combined )
+                {
+                    for ( const auto & rc : r )
+                    {
+                        product.push_back( lc );
+                        product.back( ).insert( product.back( ).end( ), rc.begin( ), rc.end( ) );
+                    }
+                }
+                combined = std::move( product );
+            }
+            results.resize( f.base );
+            results.push_back( std::move( combined ) );
+            if ( ids.shared( s ) ) { memo.insert( { key, results.back( ) } ); }
+            stack.pop_back( );
+        }
+        for ( const auto & c : results.back( ) ) { emit( c ); }
+        return result;
+    }
+
+    template< typename PRODUCER >
+    std::list< std::list< literal > > collect_list_list_literal( PRODUCER produce )
     {
         std::list< std::list< literal > > CNF;
         std::list< literal > builder;
-        to_CNF(
-            sen,
+        produce(
             common::make_function_output_iterator(
                 [&]( const std::experimental::optional< literal > & bl )
                 {
@@ -270,26 +508,40 @@ namespace first_order_logic
         return CNF;
     }
 
-    std::set< std::set< literal > > set_set_literal( const free_propositional_sentence & sen )
+    template< typename PRODUCER >
+    std::set< std::set< literal > > collect_set_set_literal( PRODUCER produce )
     {
         std::set< std::set< literal > > CNF;
         std::set< literal > builder;
-        to_CNF(
-            sen,
-        common::make_function_output_iterator(
-            [&]( const std::experimental::optional< literal > & bl )
-            {
-                if ( bl ) { builder.insert( bl.value( ) ); }
-                else
+        produce(
+            common::make_function_output_iterator(
+                [&]( const std::experimental::optional< literal > & bl )
                 {
-                    std::set< literal > tem;
-                    std::swap( tem, builder );
-                    CNF.insert( std::move( tem ) );
-                }
-            } ) );
+                    if ( bl ) { builder.insert( bl.value( ) ); }
+                    else
+                    {
+                        std::set< literal > tem;
+                        std::swap( tem, builder );
+                        CNF.insert( std::move( tem ) );
+                    }
+                } ) );
         return CNF;
     }
 
+    std::list< std::list< literal > > list_list_literal( const free_propositional_sentence & sen )
+    { return collect_list_list_literal( [&]( auto out ) { to_CNF( sen, out ); } ); }
+
+    std::list< std::list< literal > > list_list_literal(
+        const free_propositional_sentence & sen, const definitional_CNF_config & config )
+    { return collect_list_list_literal( [&]( auto out ) { definitional_CNF( sen, out, config ); } ); }
+
+    std::set< std::set< literal > > set_set_literal( const free_propositional_sentence & sen )
+    { return collect_set_set_literal( [&]( auto out ) { to_CNF( sen, out ); } ); }
+
+    std::set< std::set< literal > > set_set_literal(
+        const free_propositional_sentence & sen, const definitional_CNF_config & config )
+    { return collect_set_set_literal( [&]( auto out ) { definitional_CNF( sen, out, config ); } ); }
+
     template< typename T >
     std::list< T > set_to_list( const std::set< T > & c ) { return std::list< T >( c.begin( ), c.end( ) ); }
 
@@ -25,6 +25,19 @@ namespace first_order_logic
         namespace spirit = boost::spirit;
         namespace qi = spirit::qi;
         namespace encoding  = boost::spirit::unicode;
+        void extend_junction( boost::optional< free_sentence > & val, const free_sentence & param, sentence_type type )
+        {
+            free_sentence & s = * val;
+            if ( s->type != type || s.data.use_count( ) != 1 )
+            {
+                val = type == sentence_type::logical_and ? make_and( s, param ) : make_or( s, param );
+                return;
+            }
+            s->cache.clear( );
+            s->split.reset( );
+            if ( param->type == type ) { s->arguments.insert( s->arguments.end( ), param->arguments.begin( ), param->arguments.end( ) ); }
+            else { s->arguments.push_back( param ); }
+        }
         template< typename IT >
         struct FOL_grammar : qi::grammar< IT, boost::optional< free_sentence >( ), encoding::space_type >
         {
@@ -68,9 +81,15 @@ namespace first_order_logic
                     with_not[ _val = _1 ] >> *
                     (
                         ( lit( "/\\" ) >> with_not )
-                            [ bind( []( auto & val, auto & param ) { val = make_and( * val, * param ); }, _val, _1 ) ] |
+                            [ bind(
+                                []( auto & val, auto & param ) { extend_junction( val, * param, sentence_type::logical_and ); },
+                                _val,
+                                _1 ) ] |
                         ( ( lit( "\\/" ) >> with_not )
-                            [ bind( []( auto & val, auto & param ) { val = make_or( * val, * param ); }, _val, _1 ) ] )
+                            [ bind(
+                                []( auto & val, auto & param ) { extend_junction( val, * param, sentence_type::logical_or ); },
+                                _val,
+                                _1 ) ] )
                     );
                 with_quantifier =
                     ( lit( u8"∃" ) >> parse_variable >> expression )
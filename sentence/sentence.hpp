@@ -1,6 +1,10 @@
 #ifndef FIRST_ORDER_LOGIC_SENTENCE_SENTENCE_HPP
 #define FIRST_ORDER_LOGIC_SENTENCE_SENTENCE_HPP
 #include <type_traits>
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
 #include "function.hpp"
 #include "predicate.hpp"
 #include "term.hpp"
@@ -30,6 +34,7 @@ namespace first_order_logic
             sentence_type type;
             std::string name;
             mutable std::string cache;
+            mutable std::unique_ptr< std::pair< sentence< T >, sentence< T > > > split;
             std::vector
             <
                 boost::variant
@@ -48,10 +53,38 @@ namespace first_order_logic
                 type( st ), arguments( r.begin( ), r.end( ) ) { }
             internal( sentence_type st, const std::initializer_list< sentence< T > > & r ) :
                 type( st ), arguments( r.begin( ), r.end( ) ) { }
+            internal( sentence_type st, const std::vector< sentence< T > > & r ) :
+                type( st ), arguments( r.begin( ), r.end( ) ) { }
             internal( sentence_type st, const std::string & name ) :
                 type( st ), name( name ) { }
             internal( sentence_type ty, const variable & l, const sentence< T > & r ) :
                 type( ty ), name( l.name ), arguments( { r } ) { }
+            ~internal( )
+            {
+                std::vector< sentence< T > > pending;
+                auto release =
+                    [&]( internal & i )
+                    {
+                        for ( auto & arg : i.arguments )
+                        {
+                            sentence< T > * s = boost::get< sentence< T > >( & arg );
+                            if ( s != nullptr && s->data ) { pending.push_back( std::move( * s ) ); }
+                        }
+                        if ( i.split )
+                        {
+                            pending.push_back( std::move( i.split->first ) );
+                            pending.push_back( std::move( i.split->second ) );
+                            i.split.reset( );
+                        }
+                    };
+                release( * this );
+                while ( ! pending.empty( ) )
+                {
+                    sentence< T > s = std::move( pending.back( ) );
+                    pending.pop_back( );
+                    if ( s.data && s.data.use_count( ) == 1 ) { release( * s ); }
+                }
+            }
         };
         std::shared_ptr< internal > data;
         internal * operator ->( ) const { return data.get( ); }
@@ -116,6 +149,8 @@ namespace first_order_logic
             data( new internal( ty, il ) ) { }
         sentence( sentence_type ty, const std::initializer_list< sentence< T > > & il ) :
             data( new internal( ty, il ) ) { }
+        sentence( sentence_type ty, const std::vector< sentence< T > > & args ) :
+            data( new internal( ty, args ) ) { }
         sentence( sentence_type ty, const typename next_sentence_type< sentence< T > >::type & il ) :
             data( new internal( ty, il ) ) { }
         sentence( sentence_type ty, const variable & l, const sentence< T > & r ) :
@@ -233,6 +268,26 @@ namespace first_order_logic
                         void
                     >::value;
         };
+        std::pair< sentence< T >, sentence< T > > halves( ) const
+        {
+            if ( (*this)->split ) { return * (*this)->split; }
+            const auto & arguments = (*this)->arguments;
+            auto part =
+                [&]( size_t begin, size_t end )
+                {
+                    if ( end - begin == 1 ) { return boost::get< sentence< T > >( arguments[begin] ); }
+                    std::vector< sentence< T > > ret;
+                    ret.reserve( end - begin );
+                    for ( size_t i = begin; i < end; ++i ) { ret.push_back( boost::get< sentence< T > >( arguments[i] ) ); }
+                    return sentence< T >( (*this)->type, ret );
+                };
+            if ( arguments.size( ) == 1 ) { return { part( 0, 1 ), part( 0, 1 ) }; }
+            if ( arguments.size( ) == 2 ) { return { part( 0, 1 ), part( 1, 2 ) }; }
+            (*this)->split.reset(
+                new std::pair< sentence< T >, sentence< T > >(
+                    part( 0, arguments.size( ) / 2 ), part( arguments.size( ) / 2, arguments.size( ) ) ) );
+            return * (*this)->split;
+        }
         template< typename RET, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6 >
         RET type_restore_inner(
             const and_actor< T1 > & and_func,
@@ -245,6 +300,8 @@ namespace first_order_logic
             switch ( (*this)->type )
             {
                 case sentence_type::logical_and:
+                {
+                    std::pair< sentence< T >, sentence< T > > lr = halves( );
                     return
                         common::make_expansion(
                             []( const std::false_type &, const auto &, const auto & )
@@ -258,9 +315,10 @@ namespace first_order_logic
                                         boost::hana::type< std::integral_constant< sentence_type, sentence_type::logical_and > >),
                                         std::true_type( ),
                                         std::false_type( ) ),
-                                boost::get< sentence< T > >( (*this)->arguments[0] ),
-                                boost::get< sentence< T > >( (*this)->arguments[1] )
+                                lr.first,
+                                lr.second
                             );
+                }
                 case sentence_type::logical_not:
                     return
                         common::make_expansion(
@@ -276,6 +334,8 @@ namespace first_order_logic
                                 boost::get< sentence< T > >( (*this)->arguments[0] )
                             );
                 case sentence_type::logical_or:
+                {
+                    std::pair< sentence< T >, sentence< T > > lr = halves( );
                     return
                         common::make_expansion(
                             []( const std::false_type &, const auto &, const auto & )
@@ -289,9 +349,10 @@ namespace first_order_logic
                                         boost::hana::type< std::integral_constant< sentence_type, sentence_type::logical_or > >),
                                         std::true_type( ),
                                         std::false_type( ) ),
-                                boost::get< sentence< T > >( (*this)->arguments[0] ),
-                                boost::get< sentence< T > >( (*this)->arguments[1] )
+                                lr.first,
+                                lr.second
                             );
+                }
                 case sentence_type::all:
                     return
                         common::make_expansion(
@@ -412,56 +473,58 @@ namespace first_order_logic
                         make_atomic_actor( []( const atomic_sentence & as ) { return as; } ) );
         }
 
+        static std::string pass_string( const atomic_sentence & as )
+        { return "(" + static_cast< std::string >( as ) + ")"; }
+        template< typename N >
+        static std::string pass_string( const sentence< N > & sen ) { return static_cast< std::string >( sen ); }
         operator std::string( ) const
         {
             if ( ! (*this)->cache.empty( ) ) { return (*this)->cache; }
-            (*this)->cache =
-                    "(" +
-                    type_restore_full< std::string >
-                    (
-                        make_and_actor(
-                            [&]( const sentence< T > & l, const sentence< T > & r )
-                            {
-                                return
-                                        static_cast< std::string >( l ) +
-                                        "/\\" +
-                                        static_cast< std::string >( r );
-                            } ),
-                        make_some_actor(
-                            [&]( const variable & var, const sentence< T > & sen )
-                            {
-                                return
-                                        "∃" +
-                                        var.name +
-                                        " " +
-                                        static_cast< std::string >( sen );
-                            } ),
-                        make_all_actor(
-                            [&]( const variable & var, const sentence< T > & sen )
-                            {
-                                return
-                                        "∀" +
-                                        var.name +
-                                        " " +
-                                        static_cast< std::string >( sen );
-                            } ),
-                        make_or_actor(
-                            [&]( const sentence< T > & l, const sentence< T > & r )
-                            {
-                                return
-                                        static_cast< std::string >( l ) +
-                                        "\\/" +
-                                        static_cast< std::string >( r );
-                            } ),
-                        make_not_actor(
-                            [&]( const sentence< T > & sen )
-                            { return "!" + static_cast< std::string >( sen ); } ),
-                        make_atomic_actor(
-                            [&]( const atomic_sentence & as )
-                            { return static_cast< std::string >( as ); } )
-                    ) +
-                    ")";
-            return (*this)->cache;
+            std::string ret;
+            std::vector< std::pair< const sentence< T > *, std::string > > pending( 1, { this, "" } );
+            while ( ! pending.empty( ) )
+            {
+                std::pair< const sentence< T > *, std::string > item = std::move( pending.back( ) );
+                pending.pop_back( );
+                if ( item.first == nullptr )
+                {
+                    ret += item.second;
+                    continue;
+                }
+                const sentence< T > & s = * item.first;
+                if ( ! s->cache.empty( ) )
+                {
+                    ret += s->cache;
+                    continue;
+                }
+                switch ( s->type )
+                {
+                    case sentence_type::pass:
+                        ret += pass_string(
+                            boost::get< typename next_sentence_type< sentence< T > >::type >( s->arguments[0] ) );
+                        continue;
+                    case sentence_type::logical_not:
+                        ret += "(!";
+                        break;
+                    case sentence_type::all:
+                        ret += "(∀" + s->name + " ";
+                        break;
+                    case sentence_type::some:
+                        ret += "(∃" + s->name + " ";
+                        break;
+                    default:
+                        ret += "(";
+                }
+                pending.push_back( { nullptr, ")" } );
+                for ( size_t i = s->arguments.size( ); i > 0; --i )
+                {
+                    if ( i != s->arguments.size( ) )
+                    { pending.push_back( { nullptr, s->type == sentence_type::logical_and ? "/\\" : "\\/" } ); }
+                    pending.push_back( { & boost::get< sentence< T > >( s->arguments[i - 1] ), "" } );
+                }
+            }
+            (*this)->cache = ret;
+            return ret;
         }
     };
     typedef sentence< vector< set_c< sentence_type, sentence_type::logical_not > > > not_sen_type;
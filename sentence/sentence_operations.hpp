@@ -2,8 +2,37 @@
 #define FIRST_ORDER_LOGIC_SENTENCE_SENTENCE_OPERATIONS_HPP
 #include "sentence.hpp"
 #include "substitution.hpp"
+#include <set>
+#include <string>
+#include <vector>
+#include <utility>
+#include <experimental/optional>
 namespace first_order_logic
 {
+    template< typename QUANTIFIER, typename ATOMIC >
+    void traverse( const atomic_sentence & self, const QUANTIFIER &, const ATOMIC & atomic ) { atomic( self ); }
+
+    template< typename T, typename QUANTIFIER, typename ATOMIC >
+    void traverse( const sentence< T > & self, const QUANTIFIER & quantifier, const ATOMIC & atomic )
+    {
+        std::vector< const sentence< T > * > pending( 1, & self );
+        while ( ! pending.empty( ) )
+        {
+            const sentence< T > & s = * pending.back( );
+            pending.pop_back( );
+            if ( s->type == sentence_type::pass )
+            {
+                traverse(
+                    boost::get< typename next_sentence_type< sentence< T > >::type >( s->arguments[0] ),
+                    quantifier,
+                    atomic );
+                continue;
+            }
+            if ( s->type == sentence_type::all || s->type == sentence_type::some ) { quantifier( variable( s->name ) ); }
+            for ( const auto & arg : s->arguments ) { pending.push_back( & boost::get< sentence< T > >( arg ) ); }
+        }
+    }
+
     template< typename T >
     sentence< T > standardize_bound_variable( const sentence< T > & self ,std::set< std::string > & term_map )
     {
@@ -176,6 +205,96 @@ namespace first_order_logic
             );
     }
 
+    inline atomic_sentence rectify(
+        const atomic_sentence & self,
+        std::set< variable > &,
+        const std::set< variable > &,
+        std::set< std::string > &,
+        const substitution & renamed ) { return renamed( self ); }
+
+    template< typename T >
+    sentence< T > rectify(
+        const sentence< T > & self,
+        std::set< variable > & used_quantifier,
+        const std::set< variable > & free_variable,
+        std::set< std::string > & used_name,
+        substitution & renamed )
+    {
+        struct frame
+        {
+            const sentence< T > * node;
+            size_t next, base;
+            std::string bound;
+            std::experimental::optional< term > shadowed;
+        };
+        std::vector< frame > stack( 1, frame { & self, 0, 0, "", { } } );
+        std::vector< sentence< T > > results;
+        while ( ! stack.empty( ) )
+        {
+            frame & f = stack.back( );
+            const sentence< T > & s = * f.node;
+            if ( s->type == sentence_type::pass )
+            {
+                results.push_back(
+                    sentence< T >(
+                        sentence_type::pass,
+                        rectify(
+                            boost::get< typename next_sentence_type< sentence< T > >::type >( s->arguments[0] ),
+                            used_quantifier,
+                            free_variable,
+                            used_name,
+                            renamed ) ) );
+                stack.pop_back( );
+                continue;
+            }
+            bool quantifier = s->type == sentence_type::all || s->type == sentence_type::some;
+            if ( f.next == 0 )
+            {
+                f.base = results.size( );
+                if ( quantifier )
+                {
+                    variable v( s->name );
+                    std::string gen_str = v.name;
+                    if ( used_quantifier.count( v ) != 0 || free_variable.count( v ) != 0 )
+                    {
+                        while ( used_quantifier.count( variable( gen_str ) ) != 0 ||
+                                free_variable.count( variable( gen_str ) ) != 0 ||
+                                used_name.count( gen_str ) != 0 ) { gen_str += "_"; }
+                        used_name.insert( gen_str );
+                    }
+                    used_quantifier.insert( variable( gen_str ) );
+                    f.bound = gen_str;
+                    auto it = renamed.data.find( v );
+                    if ( it != renamed.data.end( ) ) { f.shadowed = it->second; }
+                    renamed.data[v] = make_variable( gen_str );
+                }
+            }
+            if ( f.next < s->arguments.size( ) )
+            {
+                frame child { & boost::get< sentence< T > >( s->arguments[f.next++] ), 0, 0, "", { } };
+                stack.push_back( child );
+                continue;
+            }
+            if ( quantifier )
+            {
+                variable v( s->name );
+                if ( f.shadowed ) { renamed.data[v] = * f.shadowed; }
+                else { renamed.data.erase( v ); }
+                sentence< T > ret( s->type, variable( f.bound ), results.back( ) );
+                results.back( ) = ret;
+            }
+            else
+            {
+                sentence< T > ret(
+                    s->type, std::vector< sentence< T > >( results.begin( ) + f.base, results.end( ) ) );
+                results.erase( results.begin( ) + f.base, results.end( ) );
+                results.push_back( ret );
+            }
+            stack.pop_back( );
+        }
+        return results.back( );
+    }
+
     template< typename T >
     sentence< T > rectify(
         const sentence< T > & self,
@@ -183,63 +302,8 @@ namespace first_order_logic
         const std::set< variable > & free_variable,
         std::set< std::string > & used_name )
     {
-        return self.template type_restore_full< sentence< T > >
-                (
-                    make_all_actor(
-                        [&]( const variable & v, const auto & sen )->sentence< T >
-                        {
-                            if ( used_quantifier.count( v ) != 0 || free_variable.count( v ) != 0 )
-                            {
-                                std::string gen_str = v.name;
-                                while ( used_quantifier.count( variable( gen_str ) ) != 0 ||
-                                        free_variable.count( variable( gen_str ) ) != 0 ||
-                                        used_name.count( gen_str ) != 0 ) { gen_str += "_"; }
-                                used_name.insert( gen_str );
-                                used_quantifier.insert( variable( gen_str ) );
-                                return make_all(
-                                            variable( gen_str ),
-                                            substitution(
-                                                { std::make_pair( v, make_variable( gen_str ) ) } )( sen ) );
-                            }
-                            return make_all( v, sen );
-                        } ),
-                    make_some_actor(
-                        [&]( const variable & v, const auto & sen )->sentence< T >
-                        {
-                            if ( used_quantifier.count( v ) != 0 || free_variable.count( v ) != 0 )
-                            {
-                                std::string gen_str = v.name;
-                                while ( used_quantifier.count( variable( gen_str ) ) != 0 ||
-                                        free_variable.count( variable( gen_str ) ) != 0 ||
-                                        used_name.count( gen_str ) != 0 ) { gen_str += "_"; }
-                                used_name.insert( gen_str );
-                                used_quantifier.insert( variable( gen_str ) );
-                                return make_some(
-                                            variable( gen_str ),
-                                            substitution( { { v, make_variable( gen_str ) } } )( sen ) );
-                            }
-                            return make_some( v, sen );
-                        } ),
-                    make_atomic_actor(
-                        [&]( const atomic_sentence & as )->sentence< T > { return sentence< T >( as ); } ),
-                    make_or_actor(
-                        [&]( const auto & l, const auto & r )-> sentence< T >
-                        {
-                            return make_or(
-                                    rectify( l, used_quantifier, free_variable, used_name ),
-                                    rectify( r, used_quantifier, free_variable, used_name ) );
-                        } ),
-                    make_and_actor(
-                        [&]( const auto & l, const auto & r )-> sentence< T >
-                        {
-                            return make_and(
-                                    rectify( l, used_quantifier, free_variable, used_name ),
-                                    rectify( r, used_quantifier, free_variable, used_name ) );
-                        } ),
-                    make_not_actor(
-                        [&]( const auto & sen )-> sentence< T >
-                        { return make_not( rectify( sen, used_quantifier, free_variable, used_name ) ); } )
-                );
+        substitution renamed;
+        return rectify( self, used_quantifier, free_variable, used_name, renamed );
     }
 
     template< typename T >
@@ -264,28 +328,11 @@ namespace first_order_logic
     template< typename T, typename OUTITER >
     OUTITER functions( const sentence< T > & self, OUTITER result )
     {
-        return
-            self.template type_restore_full< OUTITER >
-            (
-                make_all_actor(
-                    [&]( const variable &, const sentence< T > & s )
-                    { return functions( s, result ); } ),
-                make_some_actor(
-                    [&]( const variable &, const sentence< T > & s )
-                    { return functions( s, result ); } ),
-                make_atomic_actor(
-                    [&]( const atomic_sentence & as )
-                    { return functions( as, result ); } ),
-                make_and_actor(
-                    [&]( const sentence< T > & l, const sentence< T > & r )
-                    { return functions( l, functions( r, result ) ); } ),
-                make_or_actor(
-                    [&]( const sentence< T > & l, const sentence< T > & r )
-                    { return functions( l, functions( r, result ) ); } ),
-                make_not_actor(
-                    [&]( const sentence< T > & sen )
-                    { return functions( sen, result ); } )
-            );
+        traverse(
+            self,
+            []( const variable & ) { },
+            [&]( const atomic_sentence & as ) { result = functions( as, result ); } );
+        return result;
     }
 
     template< typename T, typename OUTITER >
@@ -387,27 +434,11 @@ namespace first_order_logic
     template< typename T, typename OUTITER >
     OUTITER free_variables( const sentence< T > & self, OUTITER result )
     {
-        return self.template type_restore_full< OUTITER >
-        (
-            make_all_actor(
-                [&]( const variable &, const sentence< T > & s )
-                { return free_variables( s, result ); } ),
-            make_some_actor(
-                [&]( const variable &, const sentence< T > & s )
-                { return free_variables( s, result ); } ),
-            make_atomic_actor(
-                [&]( const atomic_sentence & as )
-                { return free_variables( as, result ); } ),
-            make_and_actor(
-                [&]( const sentence< T > & l, const sentence< T > & r )
-                { return free_variables( l, free_variables( r, result ) ); } ),
-            make_or_actor(
-                [&]( const sentence< T > & l, const sentence< T > & r )
-                { return free_variables( l, free_variables( r, result ) ); } ),
-            make_not_actor(
-                [&]( const sentence< T > & sen )
-                { return free_variables( sen, result ); } )
-        );
+        traverse(
+            self,
+            []( const variable & ) { },
+            [&]( const atomic_sentence & as ) { result = free_variables( as, result ); } );
+        return result;
     }
 
     template< typename T >
@@ -439,28 +470,84 @@ namespace first_order_logic
     template< typename T, typename OUTITER >
     OUTITER constants( const sentence< T > & self, OUTITER result )
     {
-        return
-            self.template type_restore_full< OUTITER >
-            (
-                make_all_actor(
-                    [&]( const variable &, const sentence< T > & s )
-                    { return constants( s, result ); } ),
-                make_some_actor(
-                    [&]( const variable &, const sentence< T > & s )
-                    { return constants( s, result ); } ),
-                make_atomic_actor(
-                    [&]( const atomic_sentence & as )
-                    { return constants( as, result ); } ),
-                make_and_actor(
-                    [&]( const sentence< T > & l, const sentence< T > & r )
-                    { return constants( l, constants( r, result ) ); } ),
-                make_or_actor(
-                    [&]( const sentence< T > & l, const sentence< T > & r )
-                    { return constants( l, constants( r, result ) ); } ),
-                make_not_actor(
-                    [&]( const sentence< T > & sen )
-                    { return constants( sen, result ); } )
-            );
+        traverse(
+            self,
+            []( const variable & ) { },
+            [&]( const atomic_sentence & as ) { result = constants( as, result ); } );
+        return result;
+    }
+
+    template< typename TO, typename FROM >
+    TO quantifier_free_leaf( const FROM & f, std::true_type ) { return f; }
+
+    template< typename TO, typename FROM >
+    TO quantifier_free_leaf( const FROM & f, std::false_type ) { return TO( sentence_type::pass, f ); }
+
+    inline atomic_sentence quantifier_free_matrix(
+        const atomic_sentence & self, bool, std::vector< std::pair< sentence_type, variable > > & )
+    { return self; }
+
+    template< typename T >
+    typename remove_operator< sentence< T >, set_c< sentence_type, sentence_type::all, sentence_type::some > >::type
+    quantifier_free_matrix(
+        const sentence< T > & self, bool positive, std::vector< std::pair< sentence_type, variable > > & prefix )
+    {
+        typedef typename
+        remove_operator
+        <
+            sentence< T >,
+            set_c< sentence_type, sentence_type::all, sentence_type::some >
+        >::type ret_type;
+        struct frame
+        {
+            const sentence< T > * node;
+            bool positive;
+            size_t next, base;
+        };
+        std::vector< frame > stack( 1, frame { & self, positive, 0, 0 } );
+        std::vector< ret_type > results;
+        while ( ! stack.empty( ) )
+        {
+            frame & f = stack.back( );
+            const sentence< T > & s = * f.node;
+            if ( s->type == sentence_type::pass )
+            {
+                auto leaf =
+                    quantifier_free_matrix(
+                        boost::get< typename next_sentence_type< sentence< T > >::type >( s->arguments[0] ),
+                        f.positive,
+                        prefix );
+                results.push_back(
+                    quantifier_free_leaf< ret_type >( leaf, std::is_same< ret_type, decltype( leaf ) >( ) ) );
+                stack.pop_back( );
+                continue;
+            }
+            if ( s->type == sentence_type::all || s->type == sentence_type::some )
+            {
+                prefix.push_back(
+                    std::make_pair(
+                        ( s->type == sentence_type::all ) == f.positive ? sentence_type::all : sentence_type::some,
+                        variable( s->name ) ) );
+                f.node = & boost::get< sentence< T > >( s->arguments[0] );
+                continue;
+            }
+            if ( f.next == 0 ) { f.base = results.size( ); }
+            if ( f.next < s->arguments.size( ) )
+            {
+                frame child {
+                    & boost::get< sentence< T > >( s->arguments[f.next++] ),
+                    s->type == sentence_type::logical_not ? ! f.positive : f.positive,
+                    0,
+                    0 };
+                stack.push_back( child );
+                continue;
+            }
+            ret_type ret( s->type, std::vector< ret_type >( results.begin( ) + f.base, results.end( ) ) );
+            results.erase( results.begin( ) + f.base, results.end( ) );
+            results.push_back( ret );
+            stack.pop_back( );
+        }
+        return results.back( );
     }
 
     template< typename T >
@@ -478,117 +565,11 @@ namespace first_order_logic
             sentence< T >,
             set_c< sentence_type, sentence_type::all, sentence_type::some >
         >::type ret_type;
-        typedef sentence< vector< typename all_sentence_operator< sentence< T > >::type > > ground_type;
-        auto switch_process =
-                []( const auto & processed, const auto & unprocessed, const auto & make )
-                {
-                    return move_quantifier_out( unprocessed ).template type_restore_full< ret_type >(
-                               make_all_actor(
-                                    [&]( const variable & v, const auto & s )
-                                    {
-                                        return make_all(
-                                                    v,
-                                                    move_quantifier_out( make(
-                                                        static_cast< ground_type >( s ),
-                                                        static_cast< ground_type >( processed ) ) ) );
-                                    } ),
-                                make_some_actor(
-                                    [&]( const variable & v, const auto & s )
-                                    {
-                                        return make_some(
-                                                    v,
-                                                    move_quantifier_out( make(
-                                                        static_cast< ground_type >( s ),
-                                                        static_cast< ground_type >( processed ) ) ) );
-                                    } ),
-                                make_and_actor(
-                                    [&]( const auto & l, const auto & r )->ret_type
-                                    { return make( processed, make_and( l, r ) ); } ),
-                                make_or_actor(
-                                    [&]( const auto & l, const auto & r )->ret_type
-                                    { return make( processed, make_or( l, r ) ); } ),
-                                make_not_actor(
-                                    [&]( const auto & s )->ret_type
-                                    { return make( processed, make_not( s ) ); } ),
-                                make_atomic_actor(
-                                    [&]( const atomic_sentence & as )->ret_type
-                                    { return make( processed, as ); } ) );
-                };
-        auto do_process =
-                [&]( const auto & l, const auto & r, const auto & f )
-                {
-                    return move_quantifier_out( l ).template type_restore_full< ret_type >(
-                                make_all_actor( [&]( const variable & v, const auto & s )->ret_type
-                                { return move_quantifier_out( make_all( v, f( s, r ) ) ); } ),
-                                make_some_actor( [&]( const variable & v, const auto & s )->ret_type
-                                { return move_quantifier_out( make_some( v, f( s, r ) ) ); } ),
-                                make_and_actor( [&]( const auto & ll, const auto & rr )->ret_type
-                                { return switch_process( make_and( ll, rr ), r, f ); } ),
-                                make_or_actor( [&]( const auto & ll, const auto & rr )->ret_type
-                                { return switch_process( make_or( ll, rr ), r, f ); } ),
-                                make_not_actor(
-                                    [&]( const auto & s ) { return switch_process( make_not( s ), r, f ); } ),
-                                make_atomic_actor( [&]( const atomic_sentence & as )
-                                { return switch_process( as, r, f ); } ) );
-                };
-        return self.template type_restore_full< ret_type >
-                (
-                    make_all_actor(
-                        [&]( const variable & v, const auto & s )
-                        { return make_all( v, move_quantifier_out( s ) ); } ),
-                    make_some_actor(
-                        [&]( const variable & v, const auto & s )
-                        { return make_some( v, move_quantifier_out( s ) ); } ),
-                    make_atomic_actor( []( const atomic_sentence & as ) { return ret_type( as ); } ),
-                    make_and_actor(
-                        [&]( const auto & l, const auto & r )
-                        {
-                            return do_process(
-                                        l,
-                                        r,
-                                        []( const auto & ll, const auto & rr )
-                                        { return make_and( ll, rr ); } );
-                        } ),
-                    make_or_actor(
-                        [&]( const auto & l, const auto & r )
-                        {
-                            return do_process(
-                                        l,
-                                        r,
-                                        []( const auto & ll, const auto & rr )
-                                        { return make_or( ll, rr ); } );
-                        } ),
-                    make_not_actor(
-                        [&]( const auto & sen )->ret_type
-                        {
-                            return move_quantifier_out( sen ).template type_restore_full< ret_type >(
-                                        make_all_actor(
-                                            [&]( const variable & v, const auto & s )
-                                            {
-                                                return
-                                                    make_some(
-                                                        v,
-                                                        move_quantifier_out( make_not( ground_type( s ) ) ) );
-                                            } ),
-                                        make_some_actor(
-                                            [&]( const variable & v, const auto & s )
-                                            {
-                                                return
-                                                    make_all(
-                                                        v,
-                                                        move_quantifier_out( make_not( ground_type( s ) ) ) );
-                                            } ),
-                                        make_and_actor(
-                                            [&]( const auto & ll, const auto & rr )->ret_type
-                                            { return make_not( make_and( ll, rr ) ); } ),
-                                        make_or_actor(
-                                            [&]( const auto & ll, const auto & rr )->ret_type
-                                            { return make_not( make_or( ll, rr ) ); } ),
-                                        make_not_actor( [&]( const auto & s ) { return s; } ),
-                                        make_atomic_actor(
-                                            [&]( const atomic_sentence & as ) { return make_not( as ); } ) );
-                        } )
-                );
+        std::vector< std::pair< sentence_type, variable > > prefix;
+        auto matrix = quantifier_free_matrix( self, true, prefix );
+        ret_type ret = quantifier_free_leaf< ret_type >( matrix, std::is_same< ret_type, decltype( matrix ) >( ) );
+        for ( auto it = prefix.rbegin( ); it != prefix.rend( ); ++it ) { ret = ret_type( it->first, it->second, ret ); }
+        return ret;
     }
 
     template< typename T >
@@ -602,28 +583,15 @@ namespace first_order_logic
     template< typename T, typename OUTITER >
     OUTITER used_name( const sentence< T > & self, OUTITER result )
     {
-        return
-            self.template type_restore_full< OUTITER >
-            (
-                make_all_actor(
-                    [&]( const variable & v, const auto & s )
-                    {
-                        * result = v.name;
-                        ++result;
-                        return used_name( s, result );
-                    } ),
-                make_some_actor(
-                    [&]( const variable & v, const auto & s )
-                    {
-                        * result = v.name;
-                        ++result;
-                        return used_name( s, result );
-                    } ),
-                make_or_actor( [&]( const auto & l, const auto & r ) { return used_name( l, used_name( r, result ) ); } ),
-                make_and_actor( [&]( const auto & l, const auto & r ) { return used_name( l, used_name( r, result ) ); } ),
-                make_not_actor( [&]( const auto & sen ) { return used_name( sen, result ); } ),
-                make_atomic_actor( [&]( const atomic_sentence & sen ) { return used_name( sen, result ); } )
-            );
+        traverse(
+            self,
+            [&]( const variable & v )
+            {
+                * result = v.name;
+                ++result;
+            },
+            [&]( const atomic_sentence & as ) { result = used_name( as, result ); } );
+        return result;
     }
 
     template< typename T >
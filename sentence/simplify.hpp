@@ -0,0 +1,396 @@
+#ifndef FIRST_ORDER_LOGIC_SENTENCE_SIMPLIFY_HPP
+#define FIRST_ORDER_LOGIC_SENTENCE_SIMPLIFY_HPP
+#include "CNF.hpp"
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <boost/variant.hpp>
+#include <experimental/optional>
+namespace first_order_logic
+{
+    struct simplifier
+    {
+        enum : size_t { false_id, true_id };
+        std::vector< sentence_type > kind;
+        std::vector< std::vector< size_t > > children;
+        std::vector< const atomic_sentence * > leaf;
+        std::map< atomic_sentence, size_t > atoms;
+        std::map< std::pair< sentence_type, std::vector< size_t > >, size_t > nodes;
+        size_t work = 0;
+        simplifier( ) : kind( 2, sentence_type::pass ), children( 2 ), leaf( 2, nullptr ) { }
+        size_t intern( sentence_type type, const std::vector< size_t > & args )
+        {
+            auto it = nodes.insert( { { type, args }, kind.size( ) } );
+            if ( it.second )
+            {
+                kind.push_back( type );
+                children.push_back( args );
+                leaf.push_back( nullptr );
+            }
+            return it.first->second;
+        }
+        size_t letter( const atomic_sentence & as )
+        {
+            auto it = atoms.insert( { as, kind.size( ) } );
+            if ( it.second )
+            {
+                kind.push_back( sentence_type::pass );
+                children.emplace_back( );
+                leaf.push_back( & it.first->first );
+            }
+            return it.first->second;
+        }
+        size_t negate( size_t i )
+        {
+            if ( i <= true_id ) { return i == true_id ? false_id : true_id; }
+            if ( kind[i] == sentence_type::logical_not ) { return children[i][0]; }
+            return intern( sentence_type::logical_not, { i } );
+        }
+        size_t junction( sentence_type type, const std::vector< size_t > & args )
+        {
+            size_t absorbing = type == sentence_type::logical_and ? false_id : true_id;
+            sentence_type dual = type == sentence_type::logical_and ? sentence_type::logical_or : sentence_type::logical_and;
+            std::vector< size_t > set;
+            set.reserve( args.size( ) );
+            for ( size_t a : args )
+            {
+                if ( a == absorbing ) { return absorbing; }
+                if ( a <= true_id ) { continue; }
+                if ( kind[a] == type ) { set.insert( set.end( ), children[a].begin( ), children[a].end( ) ); }
+                else { set.push_back( a ); }
+            }
+            std::sort( set.begin( ), set.end( ) );
+            set.erase( std::unique( set.begin( ), set.end( ) ), set.end( ) );
+            auto has = [&]( size_t i ) { return std::binary_search( set.begin( ), set.end( ), i ); };
+            std::vector< size_t > kept;
+            kept.reserve( set.size( ) );
+            for ( size_t a : set )
+            {
+                if ( kind[a] == sentence_type::logical_not && has( children[a][0] ) ) { return absorbing; }
+                if ( kind[a] == dual && std::any_of( children[a].begin( ), children[a].end( ), has ) ) { continue; }
+                kept.push_back( a );
+            }
+            if ( kept.empty( ) ) { return absorbing == false_id ? true_id : false_id; }
+            if ( kept.size( ) == 1 ) { return kept.front( ); }
+            return intern( type, kept );
+        }
+        size_t operator ( )( const free_propositional_sentence & prop )
+        {
+            std::unordered_map< const void *, size_t > memo;
+            std::vector< std::pair< const free_propositional_sentence *, bool > > pending( 1, { & prop, false } );
+            while ( ! pending.empty( ) )
+            {
+                const free_propositional_sentence & s = * pending.back( ).first;
+                if ( memo.count( s.data.get( ) ) != 0 )
+                {
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( s->type == sentence_type::pass )
+                {
+                    memo.insert( { s.data.get( ), letter( boost::get< atomic_sentence >( s->arguments[0] ) ) } );
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( ! pending.back( ).second )
+                {
+                    pending.back( ).second = true;
+                    for ( const auto & arg : s->arguments )
+                    { pending.push_back( { & boost::get< free_propositional_sentence >( arg ), false } ); }
+                    continue;
+                }
+                pending.pop_back( );
+                std::vector< size_t > args;
+                args.reserve( s->arguments.size( ) );
+                for ( const auto & arg : s->arguments )
+                { args.push_back( memo.at( boost::get< free_propositional_sentence >( arg ).data.get( ) ) ); }
+                memo.insert(
+                    { s.data.get( ), s->type == sentence_type::logical_not ? negate( args[0] ) : junction( s->type, args ) } );
+            }
+            return memo.at( prop.data.get( ) );
+        }
+        size_t propagate( const free_propositional_sentence & prop )
+        {
+            size_t root = ( * this )( prop );
+            if ( root <= true_id ) { return root; }
+            size_t size = kind.size( );
+            std::vector< std::vector< size_t > > parents( size );
+            std::vector< size_t > remaining( size, 0 ), reach( 1, root );
+            std::vector< bool > reached( size, false );
+            reached[root] = true;
+            while ( ! reach.empty( ) )
+            {
+                size_t n = reach.back( );
+                reach.pop_back( );
+                remaining[n] = children[n].size( );
+                for ( size_t c : children[n] )
+                {
+                    parents[c].push_back( n );
+                    if ( ! reached[c] )
+                    {
+                        reached[c] = true;
+                        reach.push_back( c );
+                    }
+                }
+            }
+            std::vector< signed char > value( size, 0 ), top( size, 0 );
+            std::vector< std::pair< size_t, bool > > tops( 1, { root, true } ), units;
+            std::vector< size_t > assigned;
+            bool conflict = false;
+            auto polarity = []( bool positive ) { return positive ? 1 : 2; };
+            auto assign =
+                [&]( size_t n, bool v )
+                {
+                    value[n] = v ? 1 : -1;
+                    conflict = conflict || ( top[n] & polarity( ! v ) ) != 0;
+                    assigned.push_back( n );
+                };
+            auto open =
+                [&]( size_t n, bool positive )
+                {
+                    auto it = std::find_if( children[n].begin( ), children[n].end( ), [&]( size_t c ) { return value[c] == 0; } );
+                    if ( it != children[n].end( ) ) { tops.push_back( { * it, positive } ); }
+                };
+            while ( ! conflict && ( ! tops.empty( ) || ! assigned.empty( ) ) )
+            {
+                ++work;
+                if ( ! tops.empty( ) )
+                {
+                    size_t n = tops.back( ).first;
+                    bool positive = tops.back( ).second;
+                    tops.pop_back( );
+                    if ( value[n] != 0 )
+                    {
+                        conflict = ( value[n] > 0 ) != positive;
+                        continue;
+                    }
+                    if ( ( top[n] & polarity( positive ) ) != 0 ) { continue; }
+                    top[n] |= polarity( positive );
+                    if ( leaf[n] != nullptr )
+                    {
+                        units.push_back( { n, positive } );
+                        assign( n, positive );
+                    }
+                    else if ( kind[n] == sentence_type::logical_not ) { tops.push_back( { children[n][0], ! positive } ); }
+                    else if ( ( kind[n] == sentence_type::logical_and ) == positive )
+                    {
+                        for ( size_t c : children[n] ) { if ( value[c] == 0 ) { tops.push_back( { c, positive } ); } }
+                    }
+                    else if ( remaining[n] == 1 ) { open( n, positive ); }
+                    continue;
+                }
+                size_t n = assigned.back( );
+                assigned.pop_back( );
+                bool v = value[n] > 0;
+                for ( size_t p : parents[n] )
+                {
+                    ++work;
+                    if ( value[p] != 0 ) { continue; }
+                    if ( kind[p] == sentence_type::logical_not )
+                    {
+                        assign( p, ! v );
+                        continue;
+                    }
+                    bool absorbing = kind[p] == sentence_type::logical_or;
+                    if ( v == absorbing ) { assign( p, v ); }
+                    else if ( --remaining[p] == 0 ) { assign( p, ! absorbing ); }
+                    else if ( remaining[p] == 1 )
+                    {
+                        for ( bool positive : { true, false } )
+                        {
+                            if ( ( top[p] & polarity( positive ) ) != 0 && ( kind[p] == sentence_type::logical_and ) != positive )
+                            { open( p, positive ); }
+                        }
+                    }
+                }
+            }
+            if ( conflict ) { return false_id; }
+            std::unordered_map< size_t, size_t > folded;
+            std::vector< std::pair< size_t, bool > > pending( 1, { root, false } );
+            while ( ! pending.empty( ) )
+            {
+                size_t n = pending.back( ).first;
+                if ( folded.count( n ) != 0 )
+                {
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( value[n] != 0 || leaf[n] != nullptr )
+                {
+                    folded.insert( { n, value[n] == 0 ? n : value[n] > 0 ? true_id : false_id } );
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( ! pending.back( ).second )
+                {
+                    pending.back( ).second = true;
+                    for ( size_t c : children[n] ) { pending.push_back( { c, false } ); }
+                    continue;
+                }
+                pending.pop_back( );
+                std::vector< size_t > args;
+                args.reserve( children[n].size( ) );
+                for ( size_t c : children[n] ) { args.push_back( folded.at( c ) ); }
+                folded.insert(
+                    { n, kind[n] == sentence_type::logical_not ? negate( args[0] ) : junction( kind[n], args ) } );
+            }
+            std::vector< size_t > conjuncts;
+            conjuncts.reserve( units.size( ) + 1 );
+            for ( const auto & u : units ) { conjuncts.push_back( u.second ? u.first : negate( u.first ) ); }
+            conjuncts.push_back( folded.at( root ) );
+            return junction( sentence_type::logical_and, conjuncts );
+        }
+        free_propositional_sentence build( size_t root ) const
+        {
+            std::unordered_map< size_t, free_propositional_sentence > built;
+            std::vector< std::pair< size_t, bool > > pending( 1, { root, false } );
+            while ( ! pending.empty( ) )
+            {
+                size_t i = pending.back( ).first;
+                if ( built.count( i ) != 0 )
+                {
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( leaf[i] != nullptr )
+                {
+                    built.insert( { i, free_propositional_sentence( * leaf[i] ) } );
+                    pending.pop_back( );
+                    continue;
+                }
+                if ( ! pending.back( ).second )
+                {
+                    pending.back( ).second = true;
+                    for ( size_t c : children[i] ) { pending.push_back( { c, false } ); }
+                    continue;
+                }
+                pending.pop_back( );
+                std::vector< free_propositional_sentence > args;
+                args.reserve( children[i].size( ) );
+                for ( size_t c : children[i] ) { args.push_back( built.at( c ) ); }
+                built.insert( { i, free_propositional_sentence( kind[i], args ) } );
+            }
+            return built.at( root );
+        }
+    };
+
+    boost::variant< bool, free_propositional_sentence > simplify( const free_propositional_sentence & prop )
+    {
+        simplifier s;
+        size_t ret = s.propagate( prop );
+        if ( ret <= simplifier::true_id ) { return ret == simplifier::true_id; }
+        return s.build( ret );
+    }
+
+    template< typename PRODUCER, typename OUTITER >
+    OUTITER simplify_clauses( PRODUCER produce, OUTITER result )
+    {
+        std::map< atomic_sentence, size_t > atoms;
+        std::vector< const atomic_sentence * > decode;
+        std::vector< std::vector< size_t > > clauses;
+        std::vector< size_t > builder;
+        bool empty = false;
+        produce(
+            common::make_function_output_iterator(
+                [&]( const std::experimental::optional< literal > & bl )
+                {
+                    if ( bl )
+                    {
+                        auto it = atoms.insert( { bl.value( ).as, decode.size( ) } );
+                        if ( it.second ) { decode.push_back( & it.first->first ); }
+                        builder.push_back( 2 * it.first->second + ( bl.value( ).b ? 1 : 0 ) );
+                        return;
+                    }
+                    std::sort( builder.begin( ), builder.end( ) );
+                    builder.erase( std::unique( builder.begin( ), builder.end( ) ), builder.end( ) );
+                    bool tautology = false;
+                    for ( size_t i = 1; i < builder.size( ); ++i )
+                    { tautology = tautology || builder[i] == ( builder[i - 1] | 1 ); }
+                    empty = empty || builder.empty( );
+                    if ( ! tautology && ! builder.empty( ) ) { clauses.push_back( builder ); }
+                    builder.clear( );
+                } ) );
+        if ( empty )
+        {
+            * result = std::experimental::optional< literal >( );
+            ++result;
+            return result;
+        }
+        std::vector< size_t > occurrences( 2 * decode.size( ), 0 ), order( clauses.size( ) );
+        for ( size_t i = 0; i < clauses.size( ); ++i )
+        {
+            order[i] = i;
+            for ( size_t l : clauses[i] ) { ++occurrences[l]; }
+        }
+        std::stable_sort(
+            order.begin( ),
+            order.end( ),
+            [&]( size_t l, size_t r ) { return clauses[l].size( ) < clauses[r].size( ); } );
+        std::vector< std::vector< size_t > > watch( 2 * decode.size( ) );
+        std::vector< bool > kept( clauses.size( ), false );
+        for ( size_t i : order )
+        {
+            const std::vector< size_t > & c = clauses[i];
+            auto subsumes =
+                [&]( size_t j ) { return std::includes( c.begin( ), c.end( ), clauses[j].begin( ), clauses[j].end( ) ); };
+            if ( std::any_of(
+                    c.begin( ),
+                    c.end( ),
+                    [&]( size_t l ) { return std::any_of( watch[l].begin( ), watch[l].end( ), subsumes ); } ) )
+            { continue; }
+            kept[i] = true;
+            watch[* std::min_element(
+                c.begin( ),
+                c.end( ),
+                [&]( size_t l, size_t r ) { return occurrences[l] < occurrences[r]; } )].push_back( i );
+        }
+        for ( size_t i = 0; i < clauses.size( ); ++i )
+        {
+            if ( ! kept[i] ) { continue; }
+            for ( size_t l : clauses[i] )
+            {
+                * result = std::experimental::optional< literal >( literal( * decode[l / 2], l % 2 == 1 ) );
+                ++result;
+            }
+            * result = std::experimental::optional< literal >( );
+            ++result;
+        }
+        return result;
+    }
+
+    template< typename OUTITER >
+    OUTITER simplified_CNF( const free_propositional_sentence & prop, OUTITER result )
+    {
+        auto s = simplify( prop );
+        if ( const bool * b = boost::get< bool >( & s ) )
+        {
+            if ( ! * b )
+            {
+                * result = std::experimental::optional< literal >( );
+                ++result;
+            }
+            return result;
+        }
+        return simplify_clauses( [&]( auto out ) { to_CNF( boost::get< free_propositional_sentence >( s ), out ); }, result );
+    }
+
+    template< typename OUTITER >
+    OUTITER simplified_CNF( const free_propositional_sentence & prop, OUTITER result, const definitional_CNF_config & config )
+    {
+        auto s = simplify( prop );
+        if ( const bool * b = boost::get< bool >( & s ) )
+        {
+            if ( ! * b )
+            {
+                * result = std::experimental::optional< literal >( );
+                ++result;
+            }
+            return result;
+        }
+        return simplify_clauses(
+            [&]( auto out ) { definitional_CNF( boost::get< free_propositional_sentence >( s ), out, config ); }, result );
+    }
+}
+#endif //FIRST_ORDER_LOGIC_SENTENCE_SIMPLIFY_HPP
@@ -191,6 +191,37 @@ namespace first_order_logic
         auto it = ret.data.insert( { var, t } );
         return it.first->second == t ? ret : std::experimental::optional< substitution >( );
     }
+    std::experimental::optional< substitution > match( const term & pattern, const term & t, const substitution & sub )
+    {
+        switch ( pattern->term_type )
+        {
+        case term::type::variable:
+        {
+            auto it = sub.data.find( variable( pattern->name ) );
+            if ( it != sub.data.end( ) )
+            { return it->second == t ? sub : std::experimental::optional< substitution >( ); }
+            substitution ret( sub );
+            ret.data.insert( { variable( pattern->name ), t } );
+            return ret;
+        }
+        case term::type::constant:
+            return pattern == t ? sub : std::experimental::optional< substitution >( );
+        case term::type::function:
+        {
+            if ( t->term_type != term::type::function ||
+                 t->name != pattern->name ||
+                 t->arguments.size( ) != pattern->arguments.size( ) )
+            { return std::experimental::optional< substitution >( ); }
+            std::experimental::optional< substitution > ret = sub;
+            for ( size_t i = 0; ret && i < pattern->arguments.size( ); ++i )
+            { ret = match( pattern->arguments[i], t->arguments[i], * ret ); }
+            return ret;
+        }
+        }
+        throw std::invalid_argument( "unknown enum type." );
+    }
+    std::experimental::optional< substitution > match( const term & pattern, const term & t )
+    { return match( pattern, t, substitution( ) ); }
     std::experimental::optional< substitution > unify(
             const atomic_sentence & p, const atomic_sentence & q, const substitution & sub )
     {
@@ -8,9 +8,19 @@
 #include "sentence/substitution.hpp"
 #include "FOL/knowledge_base.hpp"
 #include "sentence/parser.hpp"
+#include "sentence/simplify.hpp"
 #include "FOL/resolution.hpp"
+#include "FOL/resolution_session.hpp"
+#include "FOL/instance_generation.hpp"
 #include "SAT/DPLL.hpp"
+#include "SAT/CDCL.hpp"
+#include "SAT/DIMACS.hpp"
+#include "SAT/clause_sink.hpp"
 #include "SAT/WALKSAT.hpp"
+#include "SAT/portfolio.hpp"
+#include "SAT/cube_and_conquer.hpp"
+#include "SAT/DRAT_checker.hpp"
+#include "SAT/bit_parallel.hpp"
 namespace first_order_logic
 {
     BOOST_AUTO_TEST_CASE( gentzen_system_test )
@@ -221,6 +231,132 @@ namespace first_order_logic
                         axiom7 ),
                     make_predicate( "Criminal", { make_variable( "x" ) } ) ) );
     }
+    BOOST_AUTO_TEST_CASE( demodulation_test )
+    {
+        term a = make_constant( "a" ), b = make_constant( "b" );
+        demodulator dem;
+        BOOST_CHECK(
+            dem.add(
+                {
+                    literal(
+                        make_equal(
+                            make_function( "f", { make_function( "f", { make_variable( "x" ) } ) } ),
+                            make_variable( "x" ) ),
+                        true )
+                } ) );
+        BOOST_CHECK(
+            dem.normal_form(
+                make_function( "f", { make_function( "f", { make_function( "f", { a } ) } ) } ) ) ==
+            make_function( "f", { a } ) );
+        free_sentence axiom =
+            make_and(
+                make_equal( make_function( "g", { a } ), b ),
+                make_predicate( "P", { make_function( "g", { a } ) } ) );
+        BOOST_CHECK_EQUAL( resolution( axiom, make_predicate( "P", { b } ) ), validity::valid );
+    }
+    BOOST_AUTO_TEST_CASE( resolution_proof_test )
+    {
+        resolution_proof proof;
+        free_sentence axiom =
+            make_and(
+                make_predicate( "P", { make_constant( "a" ) } ),
+                make_all(
+                    variable( "x" ),
+                    make_imply(
+                        make_predicate( "P", { make_variable( "x" ) } ),
+                        make_predicate( "Q", { make_variable( "x" ) } ) ) ) );
+        BOOST_CHECK_EQUAL(
+            resolution( axiom, make_predicate( "Q", { make_constant( "a" ) } ), proof ),
+            validity::valid );
+        auto refutation = proof.refutation( );
+        BOOST_REQUIRE( ! refutation.empty( ) );
+        BOOST_CHECK( proof[refutation.back( )].clause.empty( ) );
+        BOOST_CHECK(
+            std::all_of(
+                refutation.begin( ),
+                refutation.end( ),
+                [&]( size_t i ) { return proof[i].rule != inference_rule::discarded; } ) );
+    }
+    BOOST_AUTO_TEST_CASE( instance_generation_test )
+    {
+        auto x = make_variable( "x" ), y = make_variable( "y" ), z = make_variable( "z" );
+        free_sentence axiom =
+            make_and(
+                make_and(
+                    make_predicate( "R", { make_constant( "a" ), make_constant( "b" ) } ),
+                    make_predicate( "R", { make_constant( "b" ), make_constant( "c" ) } ) ),
+                make_and(
+                    make_predicate( "R", { make_constant( "c" ), make_constant( "d" ) } ),
+                    make_all(
+                        variable( "x" ),
+                        variable( "y" ),
+                        variable( "z" ),
+                        make_imply(
+                            make_and( make_predicate( "R", { x, y } ), make_predicate( "R", { y, z } ) ),
+                            make_predicate( "R", { x, z } ) ) ) ) );
+        BOOST_CHECK_EQUAL(
+            instance_generation( axiom, make_predicate( "R", { make_constant( "a" ), make_constant( "d" ) } ) ),
+            validity::valid );
+        BOOST_CHECK_EQUAL(
+            instance_generation( axiom, make_predicate( "R", { make_constant( "d" ), make_constant( "a" ) } ) ),
+            validity::invalid );
+        BOOST_CHECK_EQUAL(
+            instance_generation(
+                make_and(
+                    make_predicate( "P", { make_constant( "a" ) } ),
+                    make_all(
+                        variable( "x" ),
+                        make_imply(
+                            make_predicate( "P", { x } ),
+                            make_predicate( "P", { make_function( "f", { x } ) } ) ) ) ),
+                make_predicate( "P", { make_function( "f", { make_function( "f", { make_constant( "a" ) } ) } ) } ) ),
+            validity::valid );
+        instance_generation_engine engine;
+        engine.add_input( { literal( make_predicate( "P", { x } ), true ) } );
+        BOOST_CHECK( ! engine.add_input( { literal( make_predicate( "P", { y } ), true ) } ) );
+        engine.add_input( { literal( make_predicate( "P", { make_constant( "a" ) } ), false ) } );
+        BOOST_CHECK_EQUAL( engine.saturate( ).value( ), satisfiability::unsatisfiable );
+        instance_generation_engine variants;
+        BOOST_CHECK( variants.add_input(
+            { literal( make_predicate( "P", { x } ), true ),
+              literal( make_predicate( "Q", { x, y } ), true ),
+              literal( make_predicate( "P", { y } ), true ) } ) );
+        BOOST_CHECK( ! variants.add_input(
+            { literal( make_predicate( "P", { y } ), true ),
+              literal( make_predicate( "Q", { y, x } ), true ),
+              literal( make_predicate( "P", { x } ), true ) } ) );
+        BOOST_CHECK( variants.add_input(
+            { literal( make_predicate( "P", { x } ), true ),
+              literal( make_predicate( "Q", { x, x } ), true ),
+              literal( make_predicate( "P", { y } ), true ) } ) );
+    }
+    BOOST_AUTO_TEST_CASE( resolution_session_test )
+    {
+        resolution_session session(
+            make_and(
+                make_predicate( "P", { make_constant( "a" ) } ),
+                make_and(
+                    make_all(
+                        variable( "x" ),
+                        make_imply(
+                            make_predicate( "P", { make_variable( "x" ) } ),
+                            make_predicate( "Q", { make_variable( "x" ) } ) ) ),
+                    make_all(
+                        variable( "x" ),
+                        make_imply(
+                            make_predicate( "Q", { make_variable( "x" ) } ),
+                            make_predicate( "R", { make_variable( "x" ) } ) ) ) ) ) );
+        size_t clauses = session.engine.CNF.size( ), records = session.engine.proof.size( );
+        resolution_proof refutation;
+        BOOST_CHECK_EQUAL( session.prove( make_predicate( "Q", { make_constant( "a" ) } ) ), validity::valid );
+        BOOST_CHECK_EQUAL(
+            session.prove( make_predicate( "R", { make_constant( "a" ) } ), refutation ),
+            validity::valid );
+        BOOST_CHECK( refutation.empty_clause );
+        BOOST_CHECK_EQUAL( session.prove( make_predicate( "P", { make_constant( "b" ) } ) ), validity::invalid );
+        BOOST_CHECK_EQUAL( session.engine.CNF.size( ), clauses );
+        BOOST_CHECK_EQUAL( session.engine.proof.size( ), records );
+    }
     const
     std::pair
     <
@@ -271,11 +407,695 @@ namespace first_order_logic
         { BOOST_CHECK_EQUAL( DPLL( list_list_literal( p.first ) ), p.second ); }
     }
 
+    BOOST_AUTO_TEST_CASE( definitional_CNF_test )
+    {
+        for ( size_t threshold : { 0, 1, 8 } )
+        {
+            definitional_CNF_config config;
+            config.threshold = threshold;
+            for ( const auto & p : test_prop( ).first )
+            { BOOST_CHECK_EQUAL( CDCL( list_list_literal( p.first, config ) ), p.second ); }
+            for ( const auto & p : test_prop( ).second )
+            {
+                BOOST_CHECK_EQUAL(
+                    CDCL( list_list_literal( make_not( p.first ), config ) ),
+                    p.second == validity::valid ? satisfiability::unsatisfiable : satisfiability::satisfiable );
+            }
+        }
+        free_propositional_sentence disjunction( make_and( make_propositional_letter( "a0" ), make_propositional_letter( "b0" ) ) );
+        for ( size_t i = 1; i < 20; ++i )
+        {
+            disjunction =
+                make_or(
+                    disjunction,
+                    make_and(
+                        make_propositional_letter( "a" + std::to_string( i ) ),
+                        make_propositional_letter( "b" + std::to_string( i ) ) ) );
+        }
+        auto clauses = list_list_literal( disjunction, definitional_CNF_config( ) );
+        BOOST_CHECK_LE( clauses.size( ), 100u );
+        BOOST_CHECK_EQUAL( CDCL( clauses ), satisfiability::satisfiable );
+        BOOST_CHECK_EQUAL(
+            CDCL( list_list_literal( make_and( disjunction, make_not( disjunction ) ), definitional_CNF_config( ) ) ),
+            satisfiability::unsatisfiable );
+        BOOST_CHECK(
+            set_set_literal( make_or( make_propositional_letter( "A" ), make_propositional_letter( "B" ) ), definitional_CNF_config( ) ) ==
+            set_set_literal( make_or( make_propositional_letter( "A" ), make_propositional_letter( "B" ) ) ) );
+        free_propositional_sentence A( make_propositional_letter( "A" ) ), B( make_propositional_letter( "B" ) );
+        free_propositional_sentence C( make_propositional_letter( "C" ) ), D( make_propositional_letter( "D" ) );
+        definitional_CNF_config shared;
+        shared.threshold = 1;
+        std::list< std::list< literal > > appended;
+        for ( const auto & s : { make_or( make_and( A, B ), C ), make_or( make_and( make_not( A ), B ), D ), make_not( C ) } )
+        { appended.splice( appended.end( ), list_list_literal( s, shared ) ); }
+        BOOST_CHECK_EQUAL( CDCL( appended ), satisfiability::satisfiable );
+    }
+
+    BOOST_AUTO_TEST_CASE( deep_sentence_test )
+    {
+        free_propositional_sentence chain( make_propositional_letter( "P0" ) );
+        free_propositional_sentence negation( make_propositional_letter( "Q" ) );
+        for ( size_t i = 1; i <= 100000; ++i )
+        {
+            chain = make_not( make_or( make_not( chain ), make_propositional_letter( "P" + std::to_string( i ) ) ) );
+            negation = make_not( negation );
+        }
+        BOOST_CHECK_EQUAL( list_list_literal( chain ).size( ), 100001u );
+        auto negated = list_list_literal( negation );
+        BOOST_CHECK_EQUAL( negated.size( ), 1u );
+        BOOST_CHECK( negated.front( ).front( ).b );
+        std::string str = static_cast< std::string >( chain );
+        BOOST_CHECK_EQUAL( str.substr( str.size( ) - 13 ), "(P100000())))" );
+        free_sentence quantified( make_some( variable( "x0" ), make_predicate( "P", { make_variable( "x0" ) } ) ) );
+        for ( size_t i = 1; i < 20000; ++i )
+        {
+            std::string x = "x" + std::to_string( i % 100 );
+            quantified =
+                make_not(
+                    make_or(
+                        make_all( variable( x ), make_predicate( "P", { make_variable( x ) } ) ),
+                        make_not( quantified ) ) );
+        }
+        auto prenex = move_quantifier_out( rectify( quantified ) );
+        std::set< std::string > bound;
+        size_t existential = 0;
+        while ( prenex->type == sentence_type::all || prenex->type == sentence_type::some )
+        {
+            bound.insert( prenex->name );
+            existential += prenex->type == sentence_type::some;
+            prenex = boost::get< decltype( prenex ) >( prenex->arguments[0] );
+        }
+        BOOST_CHECK_EQUAL( bound.size( ), 20000u );
+        BOOST_CHECK_EQUAL( existential, 20000u );
+    }
+
+    BOOST_AUTO_TEST_CASE( memoised_CNF_test )
+    {
+        free_propositional_sentence parity( make_propositional_letter( "A0" ) );
+        for ( size_t i = 1; i <= 40; ++i )
+        {
+            parity = make_iff( parity, make_propositional_letter( "A" + std::to_string( i ) ) );
+            if ( i == 4 )
+            {
+                auto clauses = list_list_literal( parity );
+                BOOST_CHECK_EQUAL( list_list_to_set_set( clauses ).size( ), clauses.size( ) );
+                BOOST_CHECK_EQUAL( CDCL( clauses ), satisfiability::satisfiable );
+            }
+        }
+        hash_cons ids;
+        BOOST_CHECK_EQUAL( ids( make_iff( parity, parity ) ), ids( make_iff( parity, parity ) ) );
+        BOOST_CHECK_LE( ids.size, 300u );
+        auto clauses = list_list_literal( parity, definitional_CNF_config( ) );
+        BOOST_CHECK_LE( clauses.size( ), 1000u );
+        BOOST_CHECK_EQUAL( CDCL( clauses ), satisfiability::satisfiable );
+        BOOST_CHECK_EQUAL(
+            CDCL( list_list_literal( make_not( make_iff( parity, parity ) ), definitional_CNF_config( ) ) ),
+            satisfiability::unsatisfiable );
+    }
+
+    BOOST_AUTO_TEST_CASE( n_ary_sentence_test )
+    {
+        free_sentence A( make_propositional_letter( "A" ) ), B( make_propositional_letter( "B" ) );
+        free_sentence C( make_propositional_letter( "C" ) ), D( make_propositional_letter( "D" ) );
+        free_sentence conjunction( make_and( make_and( A, B ), make_and( C, D ) ) );
+        BOOST_CHECK_EQUAL( conjunction->arguments.size( ), 4u );
+        BOOST_CHECK_EQUAL( static_cast< std::string >( conjunction ), "((A())/\\(B())/\\(C())/\\(D()))" );
+        BOOST_CHECK( conjunction.halves( ).first.data == conjunction.halves( ).first.data );
+        BOOST_CHECK_EQUAL( make_or( A, B, C, D )->arguments.size( ), 4u );
+        BOOST_CHECK_EQUAL( make_or( std::vector< free_sentence > { A, make_or( B, C ), make_and( C, D ) } )->arguments.size( ), 4u );
+        free_sentence valid = make_imply( conjunction, make_or( D, B ) ), invalid = make_imply( make_or( A, B, C ), A );
+        BOOST_CHECK_EQUAL( gentzen_system::is_valid( valid ).second, validity::valid );
+        BOOST_CHECK_EQUAL( gentzen_system::is_valid( invalid ).second, validity::invalid );
+        std::string text = "P0";
+        std::vector< free_propositional_sentence > letters( 1, make_propositional_letter( "P0" ) );
+        for ( size_t i = 1; i < 10000; ++i )
+        {
+            text += " /\\ P" + std::to_string( i );
+            letters.push_back( make_propositional_letter( "P" + std::to_string( i ) ) );
+        }
+        auto parsed = parse( text );
+        BOOST_CHECK( parsed );
+        BOOST_CHECK_EQUAL( ( * parsed )->arguments.size( ), 10000u );
+        BOOST_CHECK_EQUAL( substitution( )( * parsed )->arguments.size( ), 10000u );
+        BOOST_CHECK_EQUAL( set_set_literal( make_and( letters ) ).size( ), 10000u );
+        BOOST_CHECK_EQUAL( set_set_literal( make_or( letters ) ).size( ), 1u );
+    }
+
+    BOOST_AUTO_TEST_CASE( simplify_test )
+    {
+        free_propositional_sentence A( make_propositional_letter( "A" ) ), B( make_propositional_letter( "B" ) );
+        free_propositional_sentence C( make_propositional_letter( "C" ) ), D( make_propositional_letter( "D" ) );
+        auto clauses =
+            []( const free_propositional_sentence & s )
+            { return collect_list_list_literal( [&]( auto out ) { simplified_CNF( s, out ); } ); };
+        BOOST_CHECK( boost::get< bool >( simplify( make_or( A, make_not( A ) ) ) ) );
+        BOOST_CHECK( ! boost::get< bool >( simplify( make_and( A, make_not( make_not( make_not( A ) ) ) ) ) ) );
+        BOOST_CHECK( set_set_literal( boost::get< free_propositional_sentence >( simplify( make_and( A, make_or( A, B ) ) ) ) ) ==
+                     set_set_literal( A ) );
+        BOOST_CHECK_EQUAL( clauses( make_or( A, B, A ) ).front( ).size( ), 2u );
+        BOOST_CHECK_EQUAL( clauses( make_and( make_or( A, B ), make_or( C, A, B ) ) ).size( ), 1u );
+        BOOST_CHECK_EQUAL( clauses( make_or( make_and( A, B ), make_and( make_not( A ), B ), C ) ).size( ), 1u );
+        auto propagated = clauses( make_and( A, make_or( make_not( A ), B ), make_or( make_not( B ), C, D ) ) );
+        BOOST_CHECK( list_list_to_set_set( propagated ) == set_set_literal( make_and( A, B, make_or( C, D ) ) ) );
+        auto contradiction = clauses( make_and( A, make_not( B ), make_or( make_not( A ), B ) ) );
+        BOOST_CHECK_EQUAL( contradiction.size( ), 1u );
+        BOOST_CHECK( contradiction.front( ).empty( ) );
+        BOOST_CHECK_EQUAL( CDCL( contradiction ), satisfiability::unsatisfiable );
+        BOOST_CHECK( clauses( make_or( make_and( A, B ), make_not( A ), make_not( B ) ) ).empty( ) );
+        BOOST_CHECK_EQUAL( resolution( make_and( A, make_or( make_not( A ), B ), make_not( B ) ) ), satisfiability::unsatisfiable );
+        const size_t length = 100000;
+        std::vector< free_propositional_sentence > chain( 1, make_propositional_letter( "L0" ) );
+        for ( size_t i = length; i > 0; --i )
+        {
+            chain.push_back(
+                make_or(
+                    make_not( make_propositional_letter( "L" + std::to_string( i - 1 ) ) ),
+                    make_propositional_letter( "L" + std::to_string( i ) ) ) );
+        }
+        simplifier s;
+        size_t ret = s.propagate( make_and( chain ) );
+        BOOST_REQUIRE( ret > simplifier::true_id );
+        BOOST_CHECK_EQUAL( s.children[ret].size( ), length + 1 );
+        BOOST_CHECK( std::all_of( s.children[ret].begin( ), s.children[ret].end( ), [&]( size_t c ) { return s.leaf[c] != nullptr; } ) );
+        BOOST_CHECK( s.work <= 8 * s.kind.size( ) );
+    }
+
+    std::list< std::list< literal > > pigeon_hole( size_t holes )
+    {
+        auto in = []( size_t p, size_t h )
+        { return make_propositional_letter( "P" + std::to_string( p ) + "_" + std::to_string( h ) ); };
+        std::list< std::list< literal > > ret;
+        for ( size_t p = 0; p <= holes; ++p )
+        {
+            ret.push_back( { } );
+            for ( size_t h = 0; h < holes; ++h ) { ret.back( ).push_back( literal( in( p, h ), true ) ); }
+        }
+        for ( size_t h = 0; h < holes; ++h )
+        {
+            for ( size_t p = 0; p <= holes; ++p )
+            {
+                for ( size_t q = p + 1; q <= holes; ++q )
+                { ret.push_back( { literal( in( p, h ), false ), literal( in( q, h ), false ) } ); }
+            }
+        }
+        return ret;
+    }
+
+    BOOST_AUTO_TEST_CASE( CDCL_TEST )
+    {
+        for ( const auto & p : test_prop( ).first )
+        { BOOST_CHECK_EQUAL( CDCL( list_list_literal( p.first ) ), p.second ); }
+        auto satisfiable = pigeon_hole( 6 );
+        satisfiable.pop_front( );
+        for ( auto restart :
+            {
+                CDCL_config::restart_policy::none,
+                CDCL_config::restart_policy::luby,
+                CDCL_config::restart_policy::glucose
+            } )
+        {
+            CDCL_config config;
+            config.restart = restart;
+            config.luby_unit = 4;
+            config.glucose_window = 4;
+            config.phase_saving = restart != CDCL_config::restart_policy::none;
+            BOOST_CHECK_EQUAL( CDCL( pigeon_hole( 6 ), config ), satisfiability::unsatisfiable );
+            BOOST_CHECK_EQUAL( CDCL( satisfiable, config ), satisfiability::satisfiable );
+        }
+        BOOST_CHECK_EQUAL( luby( 0 ) + luby( 1 ) + luby( 2 ) + luby( 6 ) + luby( 14 ), 1 + 1 + 2 + 4 + 8 );
+        CDCL_config config;
+        config.reduce_interval = 20;
+        config.reduce_increment = 0;
+        config.garbage_fraction = 0;
+        CDCL_solver solver( config );
+        for ( const auto & cl : pigeon_hole( 7 ) ) { solver.add_clause( cl ); }
+        BOOST_CHECK_EQUAL( solver.solve( ), satisfiability::unsatisfiable );
+        BOOST_CHECK( solver.reductions > 0 );
+        BOOST_CHECK_EQUAL( solver.arena.wasted, 0 );
+        CDCL_solver tiers;
+        for ( uint32_t v = 0; v < 8; ++v ) { tiers.new_variable( ); }
+        std::vector< literal_code > learnt { 0, 2, 4, 6, 8, 10, 12 };
+        clause_ref unused_tier2 = tiers.arena.alloc( learnt.begin( ), learnt.end( ), true, 4 );
+        tiers.learnts_tier2.push_back( unused_tier2 );
+        tiers.reduce( );
+        BOOST_CHECK( tiers.learnts_tier2.empty( ) );
+        BOOST_CHECK( tiers.learnts_local == std::vector< clause_ref >( 1, unused_tier2 ) );
+        BOOST_CHECK( ! tiers.arena[unused_tier2].deleted( ) );
+        tiers.arena[unused_tier2].set_used( true );
+        tiers.reduce( );
+        BOOST_CHECK( tiers.learnts_tier2 == std::vector< clause_ref >( 1, unused_tier2 ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( CDCL_incremental_test )
+    {
+        atomic_sentence A( make_propositional_letter( "A" ) ), B( make_propositional_letter( "B" ) ),
+            C( make_propositional_letter( "C" ) ), D( make_propositional_letter( "D" ) );
+        CDCL_solver solver;
+        solver.add_clause( std::list< literal > { literal( A, true ), literal( B, true ) } );
+        solver.add_clause( std::list< literal > { literal( A, false ), literal( C, true ) } );
+        BOOST_CHECK_EQUAL(
+            solver.solve( std::vector< literal > { literal( D, true ), literal( B, false ), literal( C, false ) } ),
+            satisfiability::unsatisfiable );
+        std::vector< literal > failed = solver.failed_assumptions( );
+        BOOST_CHECK( std::find( failed.begin( ), failed.end( ), literal( B, false ) ) != failed.end( ) );
+        BOOST_CHECK( std::find( failed.begin( ), failed.end( ), literal( C, false ) ) != failed.end( ) );
+        BOOST_CHECK( std::find( failed.begin( ), failed.end( ), literal( D, true ) ) == failed.end( ) );
+        BOOST_CHECK_EQUAL( solver.solve( std::vector< literal > { literal( B, false ) } ), satisfiability::satisfiable );
+        BOOST_CHECK( solver.model[solver.variable( A )] && solver.model[solver.variable( C )] );
+        solver.add_clause( std::list< literal > { literal( C, false ) } );
+        BOOST_CHECK_EQUAL( solver.solve( ), satisfiability::satisfiable );
+        BOOST_CHECK_EQUAL( solver.solve( std::vector< literal > { literal( B, false ) } ), satisfiability::unsatisfiable );
+        BOOST_CHECK_EQUAL( solver.failed_assumptions( ).size( ), 1 );
+        solver.add_clause( std::list< literal > { literal( B, false ) } );
+        BOOST_CHECK_EQUAL( solver.solve( ), satisfiability::unsatisfiable );
+    }
+
+    BOOST_AUTO_TEST_CASE( preprocessor_test )
+    {
+        CDCL_config config;
+        config.preprocess = true;
+        for ( const auto & p : test_prop( ).first )
+        { BOOST_CHECK_EQUAL( CDCL( list_list_literal( p.first ), config ), p.second ); }
+        std::mt19937 rd( 12345 );
+        for ( size_t round = 0; round < 40; ++round )
+        {
+            std::vector< std::vector< literal_code > > cnf;
+            for ( size_t i = 0; i < 70; ++i )
+            {
+                std::vector< literal_code > c;
+                size_t length = i % 10 == 0 ? 2 : 3;
+                for ( size_t j = 0; j < length; ++j )
+                { c.push_back( encode_literal( std::uniform_int_distribution< uint32_t >( 0, 19 )( rd ), rd( ) % 2 == 0 ) ); }
+                cnf.push_back( c );
+            }
+            CDCL_solver plain;
+            for ( const auto & c : cnf ) { plain.add_clause( c ); }
+            preprocessor pre;
+            for ( const auto & c : cnf ) { pre.add_clause( c ); }
+            bool consistent = pre.run( );
+            CDCL_solver reduced;
+            pre.simplified(
+                common::make_function_output_iterator(
+                    [&]( const std::vector< literal_code > & c ) { reduced.add_clause( c ); } ) );
+            satisfiability expected = plain.solve( );
+            BOOST_CHECK_EQUAL( consistent ? reduced.solve( ) : satisfiability::unsatisfiable, expected );
+            if ( consistent && expected == satisfiability::satisfiable )
+            {
+                std::vector< bool > model = reduced.model;
+                pre.extend( model );
+                model.resize( 20, false );
+                BOOST_CHECK(
+                    std::all_of(
+                        cnf.begin( ),
+                        cnf.end( ),
+                        [&]( const std::vector< literal_code > & c )
+                        {
+                            return std::any_of(
+                                c.begin( ),
+                                c.end( ),
+                                [&]( literal_code l ) { return model[literal_variable( l )] == literal_sign( l ); } );
+                        } ) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( model_test )
+    {
+        auto satisfies =
+            []( const std::list< std::list< literal > > & cnf, const std::map< atomic_sentence, bool > & model )
+            {
+                return std::all_of(
+                    cnf.begin( ),
+                    cnf.end( ),
+                    [&]( const std::list< literal > & c )
+                    {
+                        return std::any_of(
+                            c.begin( ),
+                            c.end( ),
+                            [&]( const literal & l ) { auto it = model.find( l.as ); return it != model.end( ) && it->second == l.b; } );
+                    } );
+            };
+        std::mt19937 rd( 11 );
+        for ( const auto & p : test_prop( ).first )
+        {
+            if ( p.second != satisfiability::satisfiable ) { continue; }
+            auto cnf = list_list_literal( p.first );
+            std::map< atomic_sentence, bool > model;
+            BOOST_CHECK( DPLL( cnf, model ) == satisfiability::satisfiable && satisfies( cnf, model ) );
+            BOOST_CHECK( CDCL( cnf, model ) == satisfiability::satisfiable && satisfies( cnf, model ) );
+            BOOST_CHECK( WALKSAT( cnf, 0.5, 1000, rd, model ) == satisfiability::satisfiable && satisfies( cnf, model ) );
+        }
+        atomic_sentence A( make_propositional_letter( "A" ) ), B( make_propositional_letter( "B" ) ),
+            C( make_propositional_letter( "C" ) );
+        std::list< std::list< literal > > cnf { { literal( A, true ), literal( B, true ) }, { literal( C, true ), literal( C, false ) } };
+        std::vector< std::map< atomic_sentence, bool > > models;
+        BOOST_CHECK_EQUAL( enumerate_models( cnf, std::back_inserter( models ) ), 6 );
+        BOOST_CHECK( std::all_of( models.begin( ), models.end( ), [&]( const auto & m ) { return satisfies( cnf, m ); } ) );
+        std::sort( models.begin( ), models.end( ) );
+        BOOST_CHECK( std::unique( models.begin( ), models.end( ) ) == models.end( ) );
+        models.clear( );
+        BOOST_CHECK_EQUAL( enumerate_models( cnf, std::back_inserter( models ), 10, { A, B } ), 3 );
+        BOOST_CHECK_EQUAL( enumerate_models( cnf, std::back_inserter( models ), 2 ), 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( DIMACS_test )
+    {
+        std::string text = "c example\np cnf 3 4\n1 -2 0\n2 3\n0 -1 0 -3\n 2 0\n%\n0\n";
+        variable_encoding encoding;
+        clause_arena arena;
+        std::vector< clause_ref > clauses;
+        std::istringstream in( text );
+        DIMACS_header header = read_DIMACS( in, encoding, arena, clauses );
+        BOOST_CHECK_EQUAL( header.variables, 3 );
+        BOOST_CHECK_EQUAL( header.clauses, 4 );
+        BOOST_REQUIRE_EQUAL( clauses.size( ), 4 );
+        BOOST_CHECK( arena[clauses[0]][1] == encode_literal( * encoding.find( make_propositional_letter( "2" ) ), false ) );
+        std::vector< std::vector< literal_code > > chunked;
+        variable_encoding chunked_encoding;
+        DIMACS_reader< std::back_insert_iterator< std::vector< std::vector< literal_code > > > >
+            reader( chunked_encoding, std::back_inserter( chunked ) );
+        DIMACS_parser< decltype( reader ) & > parser( reader );
+        for ( const char & c : text ) { parser.feed( & c, & c + 1 ); }
+        parser.finish( );
+        BOOST_REQUIRE_EQUAL( chunked.size( ), clauses.size( ) );
+        for ( size_t i = 0; i < chunked.size( ); ++i )
+        { BOOST_CHECK( std::equal( chunked[i].begin( ), chunked[i].end( ), arena[clauses[i]].begin( ) ) ); }
+        for ( const char * bad : { "p cnf 3 1\n1 4000000000 0\n", "p cnf 3 1\n-4 0\n", "1 2 0\n", "p cnf 3 1\n99999999999999999999 0\n" } )
+        {
+            variable_encoding bad_encoding;
+            std::istringstream bad_in( bad );
+            BOOST_CHECK_THROW( read_DIMACS( bad_in, bad_encoding, arena, clauses ), std::invalid_argument );
+            BOOST_CHECK_LE( bad_encoding.size( ), 3u );
+        }
+        for ( const auto & p : test_prop( ).first )
+        {
+            std::stringstream ss;
+            write_DIMACS( ss, list_list_literal( p.first ) );
+            CDCL_solver solver;
+            read_DIMACS(
+                ss,
+                solver.encoding,
+                common::make_function_output_iterator(
+                    [&]( const std::vector< literal_code > & c ) { solver.add_clause( c ); } ) );
+            BOOST_CHECK_EQUAL( solver.solve( ), p.second );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( clause_sink_test )
+    {
+        free_propositional_sentence parity( make_propositional_letter( "A0" ) );
+        for ( size_t i = 1; i <= 12; ++i )
+        { parity = make_iff( parity, free_propositional_sentence( make_propositional_letter( "A" + std::to_string( i ) ) ) ); }
+        auto produce = [&]( auto out ) { definitional_CNF( parity, out ); };
+        auto expected = collect_list_list_literal( produce );
+        size_t literals = 0;
+        for ( const auto & c : expected ) { literals += c.size( ); }
+        variable_encoding encoding;
+        clause_arena arena;
+        std::vector< clause_ref > clauses;
+        size_t drained_clauses = 0, drained_literals = 0, drains = 0;
+        arena_clause_sink arena_sink(
+            arena,
+            clauses,
+            64,
+            [&]( const clause_arena & a, const std::vector< clause_ref > & cs )
+            {
+                ++drains;
+                drained_clauses += cs.size( );
+                for ( clause_ref c : cs ) { drained_literals += a[c].size( ); }
+            } );
+        stream_clauses( produce, encoding, arena_sink ).finish( );
+        BOOST_CHECK_EQUAL( drained_clauses, expected.size( ) );
+        BOOST_CHECK_EQUAL( drained_literals, literals );
+        BOOST_CHECK( drains > 1 );
+        BOOST_CHECK( clauses.empty( ) && arena.size( ) == 0 );
+        CDCL_solver solver;
+        BOOST_CHECK( stream_clauses( produce, solver ) );
+        BOOST_CHECK_EQUAL( solver.solve( ), satisfiability::satisfiable );
+        CDCL_solver contradiction;
+        BOOST_CHECK( ! stream_clauses(
+            [&]( auto out ) { simplified_CNF( make_and( parity, make_not( parity ) ), out ); }, contradiction ) );
+        std::stringstream ss;
+        {
+            DIMACS_clause_sink sink( ss, & encoding, 64 );
+            stream_clauses( produce, encoding, sink );
+        }
+        CDCL_solver reread;
+        DIMACS_header header =
+            read_DIMACS(
+                ss,
+                reread.encoding,
+                common::make_function_output_iterator(
+                    [&]( const std::vector< literal_code > & c ) { reread.add_clause( c ); } ) );
+        BOOST_CHECK_EQUAL( header.variables, encoding.size( ) );
+        BOOST_CHECK_EQUAL( header.clauses, expected.size( ) );
+        BOOST_CHECK_EQUAL( reread.solve( ), satisfiability::satisfiable );
+        free_propositional_sentence A( make_propositional_letter( "A" ) ), B( make_propositional_letter( "B" ) );
+        free_propositional_sentence C( make_propositional_letter( "C" ) ), D( make_propositional_letter( "D" ) );
+        std::vector< std::pair< free_propositional_sentence, free_propositional_sentence > > pairs =
+            {
+                { make_or( make_and( A, B ), C ), make_and( make_or( make_and( make_not( A ), B ), D ), make_not( C ) ) },
+                { make_or( parity, make_and( A, B ) ), make_and( make_not( parity ), make_or( make_not( A ), make_not( B ) ) ) }
+            };
+        for ( const auto & p : pairs )
+        {
+            definitional_CNF_config config;
+            config.threshold = 1;
+            CDCL_solver incremental;
+            for ( const auto & s : { p.first, p.second } )
+            { stream_clauses( [&]( auto out ) { definitional_CNF( s, out, config ); }, incremental ); }
+            BOOST_CHECK_EQUAL(
+                incremental.solve( ),
+                CDCL( list_list_literal( make_and( p.first, p.second ), definitional_CNF_config( ) ) ) );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( portfolio_test )
+    {
+        portfolio_config config = default_portfolio( 4 );
+        config.local_search_workers = 1;
+        config.local_search_flips = 100000;
+        config.share_capacity = 4;
+        for ( const auto & p : test_prop( ).first )
+        { BOOST_CHECK_EQUAL( portfolio( list_list_literal( p.first ), config ), p.second ); }
+        BOOST_CHECK_EQUAL( portfolio( pigeon_hole( 7 ), config ), satisfiability::unsatisfiable );
+        auto satisfiable = pigeon_hole( 7 );
+        satisfiable.pop_front( );
+        portfolio_result result = portfolio_solve( satisfiable, config );
+        BOOST_CHECK_EQUAL( result.result, satisfiability::satisfiable );
+        BOOST_CHECK_EQUAL( result.model.size( ), result.encoding.size( ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( DRAT_test )
+    {
+        for ( size_t holes : { 4, 6 } )
+        {
+            auto cnf = pigeon_hole( holes );
+            std::ostringstream cnf_stream, proof_stream;
+            write_DIMACS( cnf_stream, cnf );
+            {
+                DRAT_writer writer( proof_stream, 64 );
+                CDCL_config config;
+                config.reduce_interval = 20;
+                std::map< atomic_sentence, bool > model;
+                BOOST_CHECK_EQUAL( CDCL( cnf, model, writer, config ), satisfiability::unsatisfiable );
+            }
+            std::string dimacs = cnf_stream.str( ), proof = proof_stream.str( );
+            std::istringstream cnf_in( dimacs ), proof_in( proof );
+            BOOST_CHECK( check_DRAT( cnf_in, proof_in ) );
+            std::vector< DRAT_step > steps;
+            parse_binary_DRAT( proof.begin( ), proof.end( ), std::back_inserter( steps ) );
+            BOOST_CHECK( ! steps.empty( ) && ! steps.back( ).deletion && steps.back( ).clause.empty( ) );
+            steps.erase( steps.begin( ), steps.end( ) - 1 );
+            std::vector< std::vector< literal_code > > formula;
+            DIMACS_parser< DRAT_formula_reader > parser( DRAT_formula_reader { formula } );
+            parser.feed( dimacs.data( ), dimacs.data( ) + dimacs.size( ) );
+            parser.finish( );
+            BOOST_CHECK( ! check_DRAT( formula, steps ) );
+        }
+        DRAT_checker checker;
+        checker.add_formula( { { 1, 2 }, { 2, 4 }, { 2, 5 } } );
+        BOOST_CHECK( ! checker.RUP( { 0 } ) );
+        BOOST_CHECK( checker.RAT( { 0 } ) );
+        BOOST_CHECK( ! checker.RAT( { 3 } ) );
+        BOOST_CHECK( check_DRAT( { { 0, 2 }, { 0, 3 }, { 1, 2 }, { 1, 3 } }, { { false, { 0 } }, { false, { } } } ) );
+        BOOST_CHECK( ! check_DRAT( { { 0, 2 }, { 0, 3 }, { 1, 2 } }, { { false, { 0 } }, { false, { } } } ) );
+        std::string satisfiable = "p cnf 2 2\n1 2 0\n-1 2 0\n";
+        std::ostringstream empty_stream, lemma_stream;
+        {
+            DRAT_writer empty( empty_stream ), lemma( lemma_stream );
+            empty.add( std::vector< literal_code > { } );
+            lemma.add( std::vector< literal_code > { 3 } );
+            lemma.add( std::vector< literal_code > { } );
+        }
+        std::istringstream empty_cnf( satisfiable ), empty_proof( empty_stream.str( ) );
+        BOOST_CHECK( ! check_DRAT( empty_cnf, empty_proof ) );
+        std::istringstream lemma_cnf( satisfiable ), lemma_proof( lemma_stream.str( ) );
+        BOOST_CHECK( ! check_DRAT( lemma_cnf, lemma_proof ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( cube_and_conquer_test )
+    {
+        cube_config config;
+        config.depth = 4;
+        config.threads = 3;
+        for ( const auto & p : test_prop( ).first )
+        { BOOST_CHECK_EQUAL( cube_and_conquer( list_list_literal( p.first ), config ), p.second ); }
+        BOOST_CHECK_EQUAL( cube_and_conquer( pigeon_hole( 7 ), config ), satisfiability::unsatisfiable );
+        auto satisfiable = pigeon_hole( 7 );
+        satisfiable.pop_front( );
+        std::map< atomic_sentence, bool > model;
+        BOOST_CHECK_EQUAL( cube_and_conquer( satisfiable, model, config ), satisfiability::satisfiable );
+        for ( const auto & cl : satisfiable )
+        {
+            BOOST_CHECK( std::any_of(
+                cl.begin( ),
+                cl.end( ),
+                [&]( const literal & l ) { return model.count( l.as ) != 0 && model.at( l.as ) == l.b; } ) );
+        }
+        free_propositional_sentence a( make_propositional_letter( "a" ) ), b( make_propositional_letter( "b" ) );
+        free_propositional_sentence c( make_propositional_letter( "c" ) );
+        BOOST_CHECK_EQUAL(
+            cube_and_conquer(
+                list_list_literal( make_and( make_or( make_not( a ), b ), make_or( make_not( a ), make_not( b ) ), make_or( a, c ) ) ),
+                config ),
+            satisfiability::satisfiable );
+        CDCL_solver solver;
+        for ( const auto & cl : pigeon_hole( 5 ) ) { solver.add_clause( cl ); }
+        std::vector< std::vector< CDCL_solver::lit > > cubes;
+        lookahead_cubes( solver, config, std::back_inserter( cubes ) );
+        BOOST_CHECK_LE( cubes.size( ), 1u << config.depth );
+        for ( const auto & c : cubes ) { BOOST_CHECK_EQUAL( solver.solve( c ), satisfiability::unsatisfiable ); }
+    }
+
     BOOST_AUTO_TEST_CASE( WALKSAT_TEST )
     {
         std::random_device rd;
         for ( const std::pair< free_propositional_sentence, satisfiability > & p : test_prop( ).first )
-        { BOOST_CHECK_EQUAL( WALKSAT( list_list_literal( p.first ), 0.5, 1000, rd ), p.second ); }
+        {
+            BOOST_CHECK_EQUAL(
+                WALKSAT( list_list_literal( p.first ), 0.5, 1000, rd ),
+                p.second == satisfiability::satisfiable ? p.second : satisfiability::unknown );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( multi_try_WALKSAT_test )
+    {
+        multi_try_config config;
+        config.max_tries = 4;
+        config.max_flips = 2000;
+        config.seed = 42;
+        for ( const auto & p : test_prop( ).first )
+        {
+            BOOST_CHECK_EQUAL(
+                multi_try_WALKSAT( list_list_literal( p.first ), config ),
+                p.second == satisfiability::satisfiable ? p.second : satisfiability::unknown );
+        }
+        BOOST_CHECK_EQUAL( multi_try_WALKSAT( pigeon_hole( 4 ), config ), satisfiability::unknown );
+        auto satisfiable = pigeon_hole( 6 );
+        satisfiable.pop_front( );
+        std::map< atomic_sentence, bool > first, second;
+        BOOST_CHECK_EQUAL( multi_try_WALKSAT( satisfiable, config, first ), satisfiability::satisfiable );
+        config.best_start = true;
+        BOOST_CHECK_EQUAL( multi_try_WALKSAT( satisfiable, config, second ), satisfiability::satisfiable );
+        config.best_start = false;
+        BOOST_CHECK_EQUAL( multi_try_WALKSAT( satisfiable, config, second ), satisfiability::satisfiable );
+        BOOST_CHECK( first == second );
+        for ( auto pick :
+            { focused_walk_config::strategy::probSAT_polynomial, focused_walk_config::strategy::probSAT_exponential } )
+        {
+            config.walk.pick = pick;
+            BOOST_CHECK_EQUAL( multi_try_WALKSAT( satisfiable, config ), satisfiability::satisfiable );
+            BOOST_CHECK_EQUAL( multi_try_WALKSAT( pigeon_hole( 4 ), config ), satisfiability::unknown );
+        }
+        BOOST_CHECK_NE( derive_seed( 42, 0 ), derive_seed( 42, 1 ) );
+        BOOST_CHECK_EQUAL( derive_seed( 42, 3 ), derive_seed( 42, 3 ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( focused_WALKSAT_TEST )
+    {
+        std::mt19937 rd( 7 );
+        for ( const std::pair< free_propositional_sentence, satisfiability > & p : test_prop( ).first )
+        {
+            auto cnf = list_list_literal( p.first );
+            std::map< atomic_sentence, bool > model;
+            satisfiability expected = p.second == satisfiability::satisfiable ? p.second : satisfiability::unknown;
+            BOOST_CHECK_EQUAL( focused_WALKSAT( cnf, 0.5, 1000, rd, model ), expected );
+            if ( p.second == satisfiability::satisfiable )
+            {
+                BOOST_CHECK(
+                    std::all_of(
+                        cnf.begin( ),
+                        cnf.end( ),
+                        [&]( const std::list< literal > & c )
+                        {
+                            return std::any_of(
+                                c.begin( ),
+                                c.end( ),
+                                [&]( const literal & l ) { return model.at( l.as ) == l.b; } );
+                        } ) );
+            }
+            for ( auto pick :
+                { focused_walk_config::strategy::probSAT_polynomial, focused_walk_config::strategy::probSAT_exponential } )
+            {
+                focused_walk_config config;
+                config.pick = pick;
+                BOOST_CHECK_EQUAL( focused_WALKSAT( cnf, config, 1000, rd, model ), expected );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( bit_parallel_test )
+    {
+        std::mt19937 rd( 11 );
+        local_search_state state( pigeon_hole( 4 ) );
+        bit_parallel_evaluator< 4 > wide( state.arena, state.clauses, state.num_variables( ) );
+        bit_parallel_evaluator< 1 > narrow( state.arena, state.clauses, state.num_variables( ) );
+        wide.randomise( rd );
+        for ( uint32_t v = 0; v < state.num_variables( ); ++v ) { narrow.assignment[v].word[0] = wide.assignment[v].word[2]; }
+        std::vector< size_t > counts = wide.unsat_counts( ), narrow_counts = narrow.unsat_counts( );
+        auto satisfied = wide.satisfied( );
+        for ( size_t lane = 0; lane < wide.lanes; ++lane )
+        {
+            for ( uint32_t v = 0; v < state.num_variables( ); ++v ) { state.assignment[v] = wide.get( lane, v ); }
+            state.initialise( );
+            BOOST_CHECK_EQUAL( counts[lane], state.unsat.size( ) );
+            BOOST_CHECK_EQUAL( satisfied.test( lane ), state.unsat.empty( ) );
+            if ( lane / 64 == 2 ) { BOOST_CHECK_EQUAL( narrow_counts[lane % 64], counts[lane] ); }
+        }
+        size_t best = best_random_start( state, rd );
+        BOOST_CHECK_EQUAL( best, state.unsat.size( ) );
+        std::map< atomic_sentence, bool > model;
+        BOOST_CHECK_EQUAL( random_screen( pigeon_hole( 4 ), 4, rd, model ), satisfiability::unknown );
+        BOOST_CHECK_EQUAL( random_screen( { { literal( make_propositional_letter( "a" ), true ) } }, 1, rd, model ), satisfiability::satisfiable );
+        BOOST_CHECK( model.at( make_propositional_letter( "a" ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( local_search_test )
+    {
+        std::mt19937 rd( 3 );
+        local_search_state state;
+        for ( size_t i = 0; i < 60; ++i )
+        {
+            std::vector< literal_code > c;
+            for ( size_t j = 0; j < 1 + i % 4; ++j )
+            { c.push_back( encode_literal( std::uniform_int_distribution< uint32_t >( 0, 14 )( rd ), rd( ) % 2 == 0 ) ); }
+            state.add_clause( c );
+        }
+        state.scored = true;
+        state.randomise( rd );
+        for ( size_t i = 0; i < 200; ++i )
+        {
+            state.flip( std::uniform_int_distribution< uint32_t >( 0, state.num_variables( ) - 1 )( rd ) );
+            local_search_state fresh = state;
+            fresh.initialise( );
+            BOOST_CHECK( state.break_count == fresh.break_count );
+            BOOST_CHECK( state.make_count == fresh.make_count );
+            BOOST_CHECK_EQUAL( state.unsat.size( ), fresh.unsat.size( ) );
+            int64_t best = state.score( 0 );
+            for ( uint32_t v = 1; v < state.num_variables( ); ++v ) { best = std::max( best, state.score( v ) ); }
+            BOOST_CHECK_EQUAL( state.score( state.best_variable( ) ), best );
+        }
     }
 
     BOOST_AUTO_TEST_CASE( PROP_RESOLUTION_TEST )